@@ -8,22 +8,17 @@
 #include <map>
 #include <thread>
 #include <chrono>
-
-#define BAUD 9600
+#include "board_tables.hpp"
+#include "board_vision.hpp"
+#include "robot_queue.hpp"
+#include "serial_config.hpp"
 
 using namespace cv;
 using namespace std;
 using namespace std::chrono;
 
-// Structure to store hole information
-struct Hole {
-    Point2f center;
-    double area;
-    int colour;
-    int row;
-    int col;
-    int position_id; // 1-9 for 3x3 grid
-};
+// Holes are the board spaces found by the shared board_vision library
+typedef Space Hole;
 
 // Global variables
 vector<Hole> savedHoles;
@@ -31,14 +26,7 @@ bool holesCalibrated = false;
 Mat emptyFrame;
 bool emptyFrameCaptured = false;
 bool continuousColorDetection = false;
-
-// Color mapping
-map<int, string> colorNames = {
-    {1, "Red"},
-    {2, "Blue"},
-    {3, "Green"},
-    {0, "None"}
-};
+ColourLUT colourLUT; // BGR -> colour class table compiled from the HSV thresholds at startup
 
 // Color character to color code mapping
 map<char, int> colorCharToCode = {
@@ -47,17 +35,6 @@ map<char, int> colorCharToCode = {
     {'g', 3}, {'G', 3}
 };
 
-// Position mapping: row and column to position_id
-// Assuming 3x3 grid layout:
-// Row 1: positions 1,2,3
-// Row 2: positions 4,5,6  
-// Row 3: positions 7,8,9
-map<pair<int, int>, int> positionMap = {
-    {{1, 1}, 1}, {{1, 2}, 2}, {{1, 3}, 3},
-    {{2, 1}, 4}, {{2, 2}, 5}, {{2, 3}, 6},
-    {{3, 1}, 7}, {{3, 2}, 8}, {{3, 3}, 9}
-};
-
 void printMenu() {
     cout << "\n=== Robot Control Menu ===" << endl;
     cout << "1. Capture Empty Matrix" << endl;
@@ -68,7 +45,7 @@ void printMenu() {
     cout << "6. Routine 2" << endl;
     cout << "7. Routine 3" << endl;
     cout << "h. Home" << endl;
-    cout << "s. Stop" << endl;
+    cout << "s. Stop (cancel queued commands)" << endl;
     cout << "r. Resume" << endl;
     cout << "q. Quit" << endl;
     cout << "Enter choice: ";
@@ -80,98 +57,8 @@ int detectColour(Mat& original, int x, int y) {
         return 0;
     }
 
-    Mat hsv;
-    cvtColor(original, hsv, COLOR_BGR2HSV);
-
-    Vec3b pixel = hsv.at<Vec3b>(y, x);
-    int hue = pixel[0];
-    int saturation = pixel[1];
-    int value = pixel[2];
-
-    if ((hue >= 140 && hue <= 180) && saturation > 100 && value > 50) {
-        return 1; // Red
-    }
-    else if (hue >= 100 && hue <= 135 && saturation > 100 && value > 50) {
-        return 2; // Blue
-    }
-    else if (hue >= 30 && hue <= 80 && saturation > 100 && value > 50) {
-        return 3; // Green
-    }
-
-    return 0;
-}
-
-// Function to detect the largest dark object (board)
-vector<Point> detectBoard(Mat& thresholded, Mat& original) {
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
-
-    findContours(thresholded, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-
-    double maxArea = 0;
-    int maxAreaIdx = -1;
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area > maxArea) {
-            maxArea = area;
-            maxAreaIdx = i;
-        }
-    }
-
-    if (maxAreaIdx >= 0 && maxArea > 10000) {
-        drawContours(original, contours, maxAreaIdx, Scalar(0, 255, 255), 3);
-        return contours[maxAreaIdx];
-    }
-
-    return vector<Point>();
-}
-
-// Function to detect holes within the board region
-vector<Hole> detectHolesInBoard(Mat& thresholded, Mat& original, const vector<Point>& boardContour) {
-    vector<Hole> holes;
-
-    if (boardContour.empty()) return holes;
-
-    Mat boardMask = Mat::zeros(thresholded.size(), CV_8UC1);
-    vector<vector<Point>> boardContours = { boardContour };
-    fillPoly(boardMask, boardContours, Scalar(255));
-
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
-
-    Mat holesImage;
-    bitwise_not(thresholded, holesImage);
-    bitwise_and(holesImage, boardMask, holesImage);
-
-    findContours(holesImage, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area < 100 || area > 10000) continue;
-
-        Point2f center;
-        float radius;
-        minEnclosingCircle(contours[i], center, radius);
-
-        if (pointPolygonTest(boardContour, center, false) >= 0) {
-            double perimeter = arcLength(contours[i], true);
-            double circularity = 0;
-            if (perimeter > 0) {
-                circularity = (4 * CV_PI * area) / (perimeter * perimeter);
-            }
-
-            if (circularity > 0.5) {
-                Hole hole;
-                hole.center = center;
-                hole.area = area;
-                hole.colour = 0;
-                holes.push_back(hole);
-            }
-        }
-    }
-
-    return holes;
+    // Same lookup table as the other front ends, so thresholds only live in one place
+    return colourLUT.classify(original.at<Vec3b>(y, x));
 }
 
 // Function to capture and process empty frame
@@ -187,34 +74,14 @@ bool captureEmptyFrame(VideoCapture& cap) {
 
     cout << "Empty frame captured! Processing holes..." << endl;
 
-    Mat imgHSV;
-    cvtColor(emptyFrame, imgHSV, COLOR_BGR2HSV);
-
-    Mat imgThresholded;
-    inRange(imgHSV, Scalar(0, 0, 0), Scalar(179, 255, 100), imgThresholded);
-
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
-    morphologyEx(imgThresholded, imgThresholded, MORPH_CLOSE, kernel);
-    morphologyEx(imgThresholded, imgThresholded, MORPH_OPEN, kernel);
-
-    vector<Point> boardContour = detectBoard(imgThresholded, emptyFrame);
-    savedHoles = detectHolesInBoard(imgThresholded, emptyFrame, boardContour);
-
-    if (!savedHoles.empty()) {
+    BoardCalibration calibration;
+    if (calibrateFromFrame(emptyFrame, colourLUT, calibration)) {
+        savedHoles = calibration.spaces;
         holesCalibrated = true;
         cout << "Successfully detected " << savedHoles.size() << " holes!" << endl;
-
-        // Sort holes by position (left to right, top to bottom)
-        sort(savedHoles.begin(), savedHoles.end(), [](const Hole& a, const Hole& b) {
-            if (a.center.y == b.center.y) return a.center.x < b.center.x;
-            return a.center.y < b.center.y;
-            });
-
-        // Assign grid positions (1-9 for 3x3 grid)
-        for (size_t i = 0; i < savedHoles.size(); i++) {
-            savedHoles[i].row = (i / 3) + 1;
-            savedHoles[i].col = 3 - (i % 3);
-            savedHoles[i].position_id = positionMap[{savedHoles[i].row, savedHoles[i].col}];
+        if (calibration.inferred > 0 || calibration.outliers > 0) {
+            cout << "Grid fit: " << calibration.inferred << " missing holes filled in, "
+                << calibration.outliers << " stray detections ignored" << endl;
         }
 
         for (size_t i = 0; i < savedHoles.size(); i++) {
@@ -229,7 +96,7 @@ bool captureEmptyFrame(VideoCapture& cap) {
         return true;
     }
     else {
-        cout << "No holes detected in empty frame!" << endl;
+        cout << "No holes grid detected in empty frame!" << endl;
         return false;
     }
 }
@@ -264,7 +131,7 @@ void checkHoleColorsLive(Mat& liveFrame) {
         cout << "Current colors: ";
         for (size_t i = 0; i < savedHoles.size(); i++) {
             cout << "R" << savedHoles[i].row << "C" << savedHoles[i].col
-                << ":" << colorNames[savedHoles[i].colour] << " ";
+                << ":" << colourName(savedHoles[i].colour) << " ";
         }
         cout << endl;
     }
@@ -301,7 +168,7 @@ void printCurrentLayout() {
             string color = "Empty";
             for (const auto& hole : savedHoles) {
                 if (hole.row == row && hole.col == col) {
-                    color = colorNames[hole.colour];
+                    color = colourName(hole.colour);
                     break;
                 }
             }
@@ -313,11 +180,7 @@ void printCurrentLayout() {
 
 // Function to get position_id from row and column
 int getPositionId(int row, int col) {
-    auto it = positionMap.find({ row, col });
-    if (it != positionMap.end()) {
-        return it->second;
-    }
-    return -1; // Invalid position
+    return boardPositionId(row, col); // -1 for an invalid position
 }
 
 // Function to find a block of specified color in column 1
@@ -331,7 +194,12 @@ Hole* findBlockByColor(int colorCode) {
 }
 
 // Function to parse move command and execute movement
-void executeMoveCommand(struct sp_port* port, const string& command) {
+void executeMoveCommand(RobotCommandQueue& queue, const string& command) {
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
+    }
+
     if (command.length() != 2) {
         cout << "Invalid command format. Use like 'r1' (color row) or 'b2' (color row)" << endl;
         return;
@@ -352,7 +220,7 @@ void executeMoveCommand(struct sp_port* port, const string& command) {
     }
 
     int colorCode = colorCharToCode[colorChar];
-    string colorName = colorNames[colorCode];
+    string colorName = colourName(colorCode);
 
     cout << "Command: Move " << colorName << " block to row " << target_row << " column 3" << endl;
 
@@ -387,7 +255,7 @@ void executeMoveCommand(struct sp_port* port, const string& command) {
     // Check if place position is empty
     if (place_hole->colour != 0) {
         cout << "Place position R" << place_hole->row << "C" << place_hole->col
-            << " is not empty! It contains " << colorNames[place_hole->colour] << " block." << endl;
+            << " is not empty! It contains " << colourName(place_hole->colour) << " block." << endl;
         return;
     }
 
@@ -398,31 +266,60 @@ void executeMoveCommand(struct sp_port* port, const string& command) {
     cout << "Block color: " << colorName << endl;
 
     // Use the exact logic you specified for command generation
-    int pick = pick_hole->row;                               
+    int pick = pick_hole->row;
     int place = place_hole->row;
-    unsigned char cmd = (unsigned char)((((pick - 1) << 4) | (place - 1)) + 1);
+    unsigned char cmd = pickPlaceCode(pick, place);
 
     cout << "Generated command: pick=" << pick << ", place=" << place << ", cmd=" << int(cmd) << endl;
 
-    // Send command sequence
-    sp_blocking_write(port, &cmd, 1, 100);
-    cout << "Command sent: " << int(cmd) << endl;
-
-    // Wait 5 seconds
-    this_thread::sleep_for(milliseconds(5000));
+    // The queue sends the command, waits for the acknowledgement (or the 5 s hold on
+    // controllers without one) and clears it; the board is updated once it has finished
+    RobotCommand move(cmd, milliseconds(5000), milliseconds(0), "Move " + colorName);
+    move.ops = { { (uint8_t)pick_hole->position_id, (uint8_t)place_hole->position_id } };
+    int pickPosition = pick_hole->position_id, placePosition = place_hole->position_id;
+    queue.submit(move,
+        [pickPosition, placePosition](const RobotCommand& command, const CommandResult& result) {
+            if (!result.ok) {
+                cout << command.label << " failed: " << result.message << endl;
+                return;
+            }
 
-    // Send zero command
-    cmd = 0;
-    sp_blocking_write(port, &cmd, 1, 100);
-    sp_drain(port);
+            // Update the board state (simulate movement)
+            Hole* from = nullptr;
+            Hole* to = nullptr;
+            for (auto& hole : savedHoles) {
+                if (hole.position_id == pickPosition) from = &hole;
+                if (hole.position_id == placePosition) to = &hole;
+            }
+            if (from && to) {
+                to->colour = from->colour;
+                from->colour = 0;
+            }
+            cout << "Movement completed!" << endl;
+        });
+}
 
-    cout << "Command reset" << endl;
+// Function to queue a single-byte routine command; only legacy controllers understand these
+void executeRawCommand(RobotCommandQueue& queue, unsigned char cmd, const string& label) {
+    if (queue.protocol != PROTOCOL_LEGACY) {
+        cout << label << " is only available on legacy controllers" << endl;
+        return;
+    }
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
+    }
 
-    // Update the board state (simulate movement)
-    place_hole->colour = pick_hole->colour;
-    pick_hole->colour = 0;
+    cout << "Sending CMD " << int(cmd) << " (" << label << ")" << endl;
+    queue.submit({ cmd, milliseconds(5000), milliseconds(0), label },
+        [](const RobotCommand& command, const CommandResult& result) {
+            cout << command.label << (result.ok ? " completed!" : " failed: " + result.message) << endl;
+        });
+}
 
-    cout << "Movement completed!" << endl;
+void printUsage() {
+    cout << "Usage: robot_menu [<port>] [--port <device>] [--baud <n>] [--protocol legacy|framed]"
+        << " [--serial-config <file>] [other serial options]" << endl;
 }
 
 int main(int argc, char* argv[])
@@ -433,36 +330,66 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    struct sp_port* port;
-    int err;
-    char cmd = 0;
-
-    if (argc < 2) {
-        fprintf(stderr, "Port use\n");
-        exit(1);
+    // Serial ports come from the same options and config files as the other front ends;
+    // a bare argument is taken as the robot port, as in "robot_menu COM3"
+    vector<SerialConfig> serialConfigs;
+    for (int i = 1; i < argc; i++) {
+        bool badOption = false;
+        string arg = argv[i];
+        if (parseSerialArg(argc, argv, i, serialConfigs, badOption)) {
+            if (badOption) return -1;
+        }
+        else if (arg.compare(0, 2, "--") != 0 && serialConfigs.empty()) {
+            SerialConfig config;
+            config.device = arg;
+            serialConfigs.push_back(config);
+        }
+        else {
+            printUsage();
+            return -1;
+        }
+    }
+    if (serialConfigs.empty()) {
+        serialConfigs.push_back(SerialConfig());
     }
 
-    err = sp_get_port_by_name("COM3", &port);
-    if (err == SP_OK)
-        err = sp_open(port, SP_MODE_WRITE);
-    if (err != SP_OK) {
-        fprintf(stderr, "Can't open port %s\n", argv[1]);
-        exit(2);
+    // Open for reading too so the controller can acknowledge finished moves
+    SerialPortSet serialPorts;
+    serialPorts.openAll(serialConfigs, SP_MODE_READ_WRITE);
+    size_t robotPort = 0;
+    for (size_t i = 0; i < serialPorts.size(); i++) {
+        if (serialPorts.config(i).name == SerialConfig().name) {
+            robotPort = i;
+            break;
+        }
+    }
+    struct sp_port* port = serialPorts.port(robotPort);
+    if (!port) {
+        cout << "Warning: Robot serial port unavailable. Running in simulation mode." << endl;
     }
-    sp_set_baudrate(port, BAUD);
-    sp_set_bits(port, 8);
+
+    RobotCommandQueue robotQueue;
+    robotQueue.writeTimeoutMs = serialPorts.config(robotPort).writeTimeoutMs;
+    robotQueue.readTimeoutMs = serialPorts.config(robotPort).readTimeoutMs;
+    robotQueue.protocol = serialPorts.config(robotPort).framedProtocol ? PROTOCOL_FRAMED : PROTOCOL_LEGACY;
 
     cout << "Robot Control System Started" << endl;
     cout << "Press '1' to capture empty matrix first" << endl;
     cout << "Move command format: 'r1' = move Red to row1,col3, 'b2' = move Blue to row2,col3" << endl;
-    
-    // Reset command
-    cmd = 0;
-    sp_blocking_write(port, &cmd, 1, 100);
+
+    // Reset command; framed controllers track each plan by sequence number instead
+    if (port && robotQueue.protocol == PROTOCOL_LEGACY) {
+        unsigned char cmd = 0;
+        sp_blocking_write(port, &cmd, 1, robotQueue.writeTimeoutMs);
+    }
+    robotQueue.start(port, true);
 
     printMenu();
 
     while (true) {
+        // Apply the results of any robot commands that finished since the last frame
+        robotQueue.dispatchCompletions();
+
         Mat liveFrame;
         if (cap.read(liveFrame)) {
             if (holesCalibrated) {
@@ -524,7 +451,7 @@ int main(int argc, char* argv[])
                 cout << "Enter move command";
                 string moveCommand;
                 cin >> moveCommand;
-                executeMoveCommand(port, moveCommand);
+                executeMoveCommand(robotQueue, moveCommand);
                 printMenu();
                 break;
             }
@@ -535,37 +462,33 @@ int main(int argc, char* argv[])
                 break;
 
             case '6':
-                cmd = 50; // Example routine command
-                cout << "Sent CMD 50 (Routine 2)" << endl;
-                sp_blocking_write(port, &cmd, 1, 100);
+                executeRawCommand(robotQueue, 50, "Routine 2"); // Example routine command
                 printMenu();
                 break;
 
             case '7':
-                cmd = 51; // Example routine command
-                cout << "Sent CMD 51 (Routine 3)" << endl;
-                sp_blocking_write(port, &cmd, 1, 100);
+                executeRawCommand(robotQueue, 51, "Routine 3"); // Example routine command
                 printMenu();
                 break;
 
             case 'h':
-                cmd = 99; // Home command
-                cout << "Sent CMD 99 (Home)" << endl;
-                sp_blocking_write(port, &cmd, 1, 100);
+                cout << "Home" << endl;
+                robotQueue.submit({ CMD_HOME, milliseconds(2000), milliseconds(0), "Home" },
+                    [](const RobotCommand& command, const CommandResult& result) {
+                        cout << command.label << (result.ok ? " position set!" : " failed: " + result.message) << endl;
+                    });
                 printMenu();
                 break;
 
             case 's':
-                cmd = 0; // Stop command
+                // Every command already ends with the 0 byte; stopping drops what is still queued
                 cout << "STOP" << endl;
-                sp_blocking_write(port, &cmd, 1, 100);
+                robotQueue.cancelPending();
                 printMenu();
                 break;
 
             case 'r':
-                cmd = 1; // Resume command
-                cout << "RESUME" << endl;
-                sp_blocking_write(port, &cmd, 1, 100);
+                executeRawCommand(robotQueue, 1, "Resume");
                 printMenu();
                 break;
 
@@ -573,7 +496,7 @@ int main(int argc, char* argv[])
             case 'Q':
             case 27:
                 cout << "Quitting..." << endl;
-                sp_close(port);
+                robotQueue.stop();
                 return 0;
 
             default:
@@ -582,6 +505,6 @@ int main(int argc, char* argv[])
         }
     }
 
-    sp_close(port);
+    robotQueue.stop();
     return 0;
 }
@@ -0,0 +1,414 @@
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <filesystem>
+#include "colour_classifier.hpp"
+#include "board_calibration.hpp"
+#include "colour_dataset.hpp"
+#include "board_rectifier.hpp"
+
+// Accuracy and throughput suite for the space colour classifiers.
+//
+// Usage:
+//   bench_colour generate <dir> [--frames <n>] [--seed <n>]
+//       Renders a synthetic labelled dataset (see colour_dataset.hpp) of red/blue/green
+//       blocks on a 3x3 board under varying brightness, noise and block placement.
+//   bench_colour run <dir> [--classifier <name>] [--repeat <n>]
+//       Scores every registered classifier (or just the named one) on the dataset and
+//       reports accuracy, the confusion matrix and the time per space classified.
+
+using namespace cv;
+using namespace std;
+using namespace std::chrono;
+
+// ===================================================================================
+//                        CLASSIFIERS UNDER TEST
+// ===================================================================================
+// Anything that turns a frame into one colour code per labelled space. prepare() is given
+// the space centres once, in label column order, with the calibration they come from;
+// classify() is what gets timed.
+class SpaceClassifierUnderTest {
+public:
+    virtual ~SpaceClassifierUnderTest() {}
+    virtual string name() const = 0;
+    virtual void prepare(const vector<Point2f>& centres, const BoardCalibration& calibration) = 0;
+    virtual void classify(const Mat& frame, vector<int>& colours) = 0;
+};
+
+// The original detectColour: convert the centre pixel to HSV and apply the thresholds
+class PixelHSVClassifier : public SpaceClassifierUnderTest {
+public:
+    string name() const { return "pixel-hsv"; }
+
+    void prepare(const vector<Point2f>& centres, const BoardCalibration& calibration) {
+        points.clear();
+        for (const Point2f& c : centres) points.push_back(Point((int)c.x, (int)c.y));
+        frameRect = Rect(Point(0, 0), calibration.frameSize);
+    }
+
+    void classify(const Mat& frame, vector<int>& colours) {
+        colours.assign(points.size(), COLOUR_NONE);
+        Mat hsv;
+        for (size_t i = 0; i < points.size(); i++) {
+            if (!frameRect.contains(points[i])) continue;
+            cvtColor(frame(Rect(points[i].x, points[i].y, 1, 1)), hsv, COLOR_BGR2HSV);
+            Vec3b pixel = hsv.at<Vec3b>(0, 0);
+            colours[i] = thresholds.classify(pixel[0], pixel[1], pixel[2]);
+        }
+    }
+
+private:
+    ColourThresholds thresholds;
+    vector<Point> points;
+    Rect frameRect;
+};
+
+// The centre pixel through the BGR lookup table
+class PixelLUTClassifier : public SpaceClassifierUnderTest {
+public:
+    string name() const { return "pixel-lut"; }
+
+    void prepare(const vector<Point2f>& centres, const BoardCalibration& calibration) {
+        points.clear();
+        for (const Point2f& c : centres) points.push_back(Point((int)c.x, (int)c.y));
+        frameRect = Rect(Point(0, 0), calibration.frameSize);
+    }
+
+    void classify(const Mat& frame, vector<int>& colours) {
+        colours.assign(points.size(), COLOUR_NONE);
+        for (size_t i = 0; i < points.size(); i++) {
+            if (!frameRect.contains(points[i])) continue;
+            colours[i] = lut.classify(frame.at<Vec3b>(points[i].y, points[i].x));
+        }
+    }
+
+private:
+    ColourLUT lut;
+    vector<Point> points;
+    Rect frameRect;
+};
+
+// The live program's classifier: majority vote over a disc through the lookup table. With
+// 'rectified' set each frame is first warped to the top-down board view and the discs are
+// sampled there, exactly as final.cpp and bench_replay do, and the warp is part of the time;
+// without it the discs are sampled from the raw camera frame.
+class PatchLUTClassifier : public SpaceClassifierUnderTest {
+public:
+    explicit PatchLUTClassifier(bool rectified) : rectified(rectified) {}
+
+    string name() const { return rectified ? "patch-lut" : "patch-lut-raw"; }
+
+    void prepare(const vector<Point2f>& centres, const BoardCalibration& calibration) {
+        rectifier.clear();
+        if (rectified && !rectifier.calibrate(calibration.boardContour)) {
+            cout << name() << ": board outline has no corners, sampling the raw frame" << endl;
+        }
+        vector<Point2f> sampled;
+        for (const Point2f& c : centres) sampled.push_back(rectifier.ready() ? rectifier.project(c) : c);
+        classifier.calibrate(sampled, rectifier.ready() ? rectifier.boardSize() : calibration.frameSize);
+    }
+
+    void classify(const Mat& frame, vector<int>& colours) {
+        if (rectifier.ready()) {
+            rectifier.rectify(frame, board);
+            classifier.classify(board, lut, readings);
+        }
+        else {
+            classifier.classify(frame, lut, readings);
+        }
+        colours.resize(readings.size());
+        for (size_t i = 0; i < readings.size(); i++) colours[i] = readings[i].colour;
+    }
+
+private:
+    bool rectified;
+    ColourLUT lut;
+    BoardRectifier rectifier;
+    SpaceColourClassifier classifier;
+    vector<SpaceReading> readings;
+    Mat board;
+};
+
+// Every implementation the runner knows about; add new classifiers here
+vector<unique_ptr<SpaceClassifierUnderTest>> makeClassifiers() {
+    vector<unique_ptr<SpaceClassifierUnderTest>> classifiers;
+    classifiers.push_back(unique_ptr<SpaceClassifierUnderTest>(new PixelHSVClassifier()));
+    classifiers.push_back(unique_ptr<SpaceClassifierUnderTest>(new PixelLUTClassifier()));
+    classifiers.push_back(unique_ptr<SpaceClassifierUnderTest>(new PatchLUTClassifier(false)));
+    classifiers.push_back(unique_ptr<SpaceClassifierUnderTest>(new PatchLUTClassifier(true)));
+    return classifiers;
+}
+
+// ===================================================================================
+//                        SYNTHETIC DATASET GENERATOR
+// ===================================================================================
+const Size SYNTH_FRAME(640, 480);
+const int SYNTH_SPACING = 90;      // Distance between neighbouring space centres
+const int SYNTH_SPACE_RADIUS = 22;
+const int SYNTH_BLOCK_SIZE = 34;
+const Point SYNTH_FIRST_SPACE(230, 150); // Top-left space centre
+
+// Typical hue of each block colour in OpenCV's 0-180 scale (index = colour code)
+const int SYNTH_HUE[COLOUR_CLASSES] = { 0, 165, 118, 55 };
+
+// Geometry of the synthetic board, numbered the same way captureEmptyFrame numbers it
+BoardCalibration syntheticCalibration() {
+    BoardCalibration calibration;
+    calibration.frameSize = SYNTH_FRAME;
+
+    int margin = SYNTH_SPACING / 2 + 15;
+    Point topLeft = SYNTH_FIRST_SPACE - Point(margin, margin);
+    Point bottomRight = SYNTH_FIRST_SPACE + Point(2 * SYNTH_SPACING + margin, 2 * SYNTH_SPACING + margin);
+    calibration.boardContour = { topLeft, Point(bottomRight.x, topLeft.y), bottomRight, Point(topLeft.x, bottomRight.y) };
+
+    for (int row = 1; row <= 3; row++) {
+        for (int i = 0; i < 3; i++) {
+            Space space = Space();
+            space.center = Point2f((float)(SYNTH_FIRST_SPACE.x + i * SYNTH_SPACING),
+                (float)(SYNTH_FIRST_SPACE.y + (row - 1) * SYNTH_SPACING));
+            space.area = CV_PI * SYNTH_SPACE_RADIUS * SYNTH_SPACE_RADIUS;
+            space.row = row;
+            space.col = 3 - i; // Columns are numbered from the right
+            space.position_id = (space.row - 1) * 3 + space.col;
+            calibration.spaces.push_back(space);
+        }
+    }
+    return calibration;
+}
+
+Scalar hsvToBgr(int hue, int saturation, int value) {
+    Mat pixel(1, 1, CV_8UC3, Scalar(hue, saturation, value));
+    cvtColor(pixel, pixel, COLOR_HSV2BGR);
+    Vec3b bgr = pixel.at<Vec3b>(0, 0);
+    return Scalar(bgr[0], bgr[1], bgr[2]);
+}
+
+// Draws one frame with the given colour on each space, then applies a global brightness
+// change and sensor noise
+Mat renderSyntheticFrame(const BoardCalibration& calibration, const vector<int>& colours, RNG& rng) {
+    Mat frame(SYNTH_FRAME, CV_8UC3, Scalar(150, 160, 170));
+
+    vector<vector<Point>> board = { calibration.boardContour };
+    fillPoly(frame, board, Scalar(35, 35, 40));
+
+    for (size_t i = 0; i < calibration.spaces.size(); i++) {
+        Point centre = calibration.spaces[i].center;
+        circle(frame, centre, SYNTH_SPACE_RADIUS, Scalar(205, 205, 200), FILLED);
+
+        int colour = colours[i];
+        if (colour == COLOUR_NONE) continue;
+
+        // Blocks are never placed exactly on the centre and vary in shade
+        int hue = SYNTH_HUE[colour] + rng.uniform(-6, 7);
+        if (hue >= 180) hue -= 180;
+        Scalar bgr = hsvToBgr(hue, rng.uniform(170, 256), rng.uniform(150, 256));
+        Point offset(rng.uniform(-4, 5), rng.uniform(-4, 5));
+        Point half(SYNTH_BLOCK_SIZE / 2, SYNTH_BLOCK_SIZE / 2);
+        rectangle(frame, centre + offset - half, centre + offset + half, bgr, FILLED);
+    }
+
+    double gain = rng.uniform(0.55, 1.35);
+    frame.convertTo(frame, -1, gain, 0);
+
+    Mat noise(frame.size(), CV_16SC3);
+    randn(noise, Scalar::all(0), Scalar::all(rng.uniform(1.0, 8.0)));
+    Mat noisy;
+    frame.convertTo(noisy, CV_16SC3);
+    noisy += noise;
+    noisy.convertTo(frame, CV_8UC3);
+    return frame;
+}
+
+int generateDataset(const string& dir, int frameCount, uint64 seed) {
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+
+    ColourDataset dataset;
+    dataset.calibration = syntheticCalibration();
+    for (const Space& space : dataset.calibration.spaces) {
+        dataset.positions.push_back(space.position_id);
+    }
+
+    RNG rng(seed);
+    for (int f = 0; f < frameCount; f++) {
+        LabelledFrame labelled;
+        for (size_t i = 0; i < dataset.positions.size(); i++) {
+            // Roughly a third of the spaces are empty
+            int colour = rng.uniform(0, 3) == 0 ? COLOUR_NONE : rng.uniform(COLOUR_RED, COLOUR_CLASSES);
+            labelled.expected.push_back(colour);
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%05d.png", f);
+        labelled.image = name;
+
+        Mat frame = renderSyntheticFrame(dataset.calibration, labelled.expected, rng);
+        if (!imwrite(dir + "/" + labelled.image, frame)) {
+            cout << "Cannot write " << dir << "/" << labelled.image << endl;
+            return 1;
+        }
+        dataset.frames.push_back(labelled);
+    }
+
+    if (!saveDataset(dir, dataset)) {
+        cout << "Cannot write the labels to " << dir << endl;
+        return 1;
+    }
+    cout << "Wrote " << frameCount << " labelled frames to " << dir << endl;
+    return 0;
+}
+
+// ===================================================================================
+//                        RUNNER
+// ===================================================================================
+const char* CLASS_LABELS[] = { "Uncertain", "None", "Red", "Blue", "Green" };
+
+int runSuite(const string& dir, const string& only, int repeat) {
+    ColourDataset dataset;
+    if (!loadDataset(dir, dataset)) {
+        cout << "Cannot load dataset from " << dir << endl;
+        return 1;
+    }
+
+    // Space centres in label column order
+    vector<Point2f> centres;
+    for (int position : dataset.positions) {
+        bool found = false;
+        for (const Space& space : dataset.calibration.spaces) {
+            if (space.position_id == position) {
+                centres.push_back(space.center);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            cout << "Position " << position << " is labelled but not in the calibration" << endl;
+            return 1;
+        }
+    }
+
+    // Decode every frame up front so only classification is timed
+    vector<Mat> frames;
+    for (const LabelledFrame& labelled : dataset.frames) {
+        Mat frame = imread(dir + "/" + labelled.image, IMREAD_COLOR);
+        if (frame.empty() || frame.size() != dataset.calibration.frameSize) {
+            cout << "Cannot use " << labelled.image << " (missing or wrong size)" << endl;
+            return 1;
+        }
+        frames.push_back(frame);
+    }
+    if (frames.empty()) {
+        cout << "Dataset has no frames" << endl;
+        return 1;
+    }
+    cout << "Dataset: " << frames.size() << " frames x " << centres.size() << " spaces" << endl;
+
+    bool ranAny = false;
+    vector<unique_ptr<SpaceClassifierUnderTest>> classifiers = makeClassifiers();
+    for (auto& classifier : classifiers) {
+        if (!only.empty() && classifier->name() != only) continue;
+        ranAny = true;
+        classifier->prepare(centres, dataset.calibration);
+
+        // Accuracy pass: rows are the expected colour, columns the reported one (incl. uncertain)
+        long confusion[COLOUR_CLASSES][COLOUR_CLASSES + 1] = {};
+        long correct = 0, total = 0;
+        vector<int> colours;
+        for (size_t f = 0; f < frames.size(); f++) {
+            classifier->classify(frames[f], colours);
+            for (size_t i = 0; i < colours.size(); i++) {
+                int expected = dataset.frames[f].expected[i];
+                if (expected < COLOUR_NONE || expected >= COLOUR_CLASSES) continue;
+                confusion[expected][colours[i] + 1]++;
+                if (colours[i] == expected) correct++;
+                total++;
+            }
+        }
+
+        // Throughput pass over the whole dataset, repeated to smooth out timer resolution
+        auto started = steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            for (const Mat& frame : frames) {
+                classifier->classify(frame, colours);
+            }
+        }
+        double elapsedNs = (double)duration_cast<nanoseconds>(steady_clock::now() - started).count();
+        double nsPerSpace = elapsedNs / ((double)repeat * frames.size() * centres.size());
+
+        cout << endl << "== " << classifier->name() << " ==" << endl;
+        printf("Accuracy: %.2f%% (%ld/%ld)\n", total ? 100.0 * correct / total : 0.0, correct, total);
+        printf("Time:     %.1f ns/space\n", nsPerSpace);
+        printf("%-10s", "expected");
+        for (int p = 0; p <= COLOUR_CLASSES; p++) printf("%10s", CLASS_LABELS[p]);
+        printf("\n");
+        for (int e = 0; e < COLOUR_CLASSES; e++) {
+            printf("%-10s", CLASS_LABELS[e + 1]);
+            for (int p = 0; p <= COLOUR_CLASSES; p++) printf("%10ld", confusion[e][p]);
+            printf("\n");
+        }
+    }
+
+    if (!ranAny) {
+        cout << "Unknown classifier: " << only << endl;
+        return 1;
+    }
+    return 0;
+}
+
+void printUsage() {
+    cout << "Usage:" << endl;
+    cout << "  bench_colour generate <dir> [--frames <n>] [--seed <n>]" << endl;
+    cout << "  bench_colour run <dir> [--classifier <name>] [--repeat <n>]" << endl;
+    cout << "Classifiers:";
+    for (auto& classifier : makeClassifiers()) cout << " " << classifier->name();
+    cout << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    string mode = argv[1];
+    string dir = argv[2];
+    int frameCount = 200;
+    uint64 seed = 12345;
+    string only;
+    int repeat = 20;
+
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            frameCount = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--classifier" && i + 1 < argc) {
+            only = argv[++i];
+        }
+        else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (mode == "generate") {
+        return generateDataset(dir, frameCount, seed);
+    }
+    if (mode == "run") {
+        return runSuite(dir, only, repeat);
+    }
+    printUsage();
+    return 1;
+}
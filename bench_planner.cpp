@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "move_planner.hpp"
+
+// Timing benchmark for the move planners on the 3x3 board and on larger boards. Reports the
+// worst time of each case over the repeats; plan validity and optimality are checked by
+// test_planner. Exits with 1 only if a planner fails to produce a usable plan.
+//
+// Usage: bench_planner [--repeat <n>]
+
+using namespace std;
+using namespace std::chrono;
+
+// Every space of a rows x cols board, in position_id order
+vector<GridCell> boardCells(int rows, int cols) {
+    vector<GridCell> cells;
+    for (int row = 1; row <= rows; row++) {
+        for (int col = 1; col <= cols; col++) {
+            cells.push_back(GridCell{ (row - 1) * cols + col, row, col });
+        }
+    }
+    return cells;
+}
+
+// Replays the plan on 'layout' and reports whether every pick had a block and every place was empty
+bool applyPlan(const vector<GridCell>& cells, BoardLayout& layout, const MovePlan& plan) {
+    for (const PlannedMove& move : plan.moves) {
+        int pick = -1, place = -1;
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (cells[i].position_id == move.pick.position_id) pick = (int)i;
+            if (cells[i].position_id == move.place.position_id) place = (int)i;
+        }
+        if (pick < 0 || place < 0 || layout[pick] == 0 || layout[place] != 0) return false;
+        layout[place] = layout[pick];
+        layout[pick] = 0;
+    }
+    return true;
+}
+
+struct CaseResult {
+    bool ok;
+    double worstMs;
+    string detail;
+};
+
+void report(const string& name, const CaseResult& result, bool& allPlanned) {
+    if (!result.ok) allPlanned = false;
+    printf("%-24s %10.3f ms  %s%s\n", name.c_str(), result.worstMs, result.detail.c_str(), result.ok ? "" : " (FAILED)");
+}
+
+// Moves every block in 'fromCol' to the empty spaces of 'toCol', as executeReset does
+CaseResult transferCase(int rows, int cols, int fromCol, int toCol, int repeat) {
+    vector<GridCell> cells = boardCells(rows, cols), blocks, spaces;
+    for (const GridCell& cell : cells) {
+        if (cell.col == fromCol) blocks.push_back(cell);
+        if (cell.col == toCol) spaces.push_back(cell);
+    }
+    MoveCostModel model;
+    model.homeRow = (rows + 1) / 2.0;
+    model.homeCol = (cols + 1) / 2.0;
+
+    CaseResult result = { true, 0, "" };
+    MovePlan plan;
+    for (int i = 0; i < repeat; i++) {
+        auto started = steady_clock::now();
+        plan = planTransfers(blocks, spaces, model, true);
+        result.worstMs = max(result.worstMs, duration<double, milli>(steady_clock::now() - started).count());
+    }
+    result.ok = plan.moves.size() == min(blocks.size(), spaces.size());
+    result.detail = to_string(plan.moves.size()) + " moves" + (plan.optimal ? "" : " (greedy)");
+    return result;
+}
+
+// Blocks scattered over most of the board, with a handful of free spaces
+CaseResult crowdedTransferCase(int rows, int cols, int repeat) {
+    vector<GridCell> cells = boardCells(rows, cols), blocks, spaces;
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (i % 3 == 0) spaces.push_back(cells[i]);
+        else blocks.push_back(cells[i]);
+    }
+    MoveCostModel model;
+    CaseResult result = { true, 0, "" };
+    MovePlan plan;
+    for (int i = 0; i < repeat; i++) {
+        auto started = steady_clock::now();
+        plan = planTransfers(blocks, spaces, model, false);
+        result.worstMs = max(result.worstMs, duration<double, milli>(steady_clock::now() - started).count());
+    }
+    result.ok = plan.moves.size() == min(blocks.size(), spaces.size());
+    result.detail = to_string(blocks.size()) + " blocks, " + to_string(spaces.size()) + " spaces" +
+        (plan.optimal ? "" : " (greedy)");
+    return result;
+}
+
+// Rearranges 'current' into 'target' and checks the plan really produces it
+CaseResult layoutCase(int rows, int cols, const BoardLayout& current, const BoardLayout& target,
+    bool legacyMovesOnly, int repeat) {
+    vector<GridCell> cells = boardCells(rows, cols);
+    MoveCostModel model;
+    model.homeRow = (rows + 1) / 2.0;
+    model.homeCol = (cols + 1) / 2.0;
+
+    CaseResult result = { true, 0, "" };
+    MovePlan plan;
+    string error;
+    for (int i = 0; i < repeat; i++) {
+        LayoutPlanner planner; // Fresh each time so the cache does not hide the search
+        auto started = steady_clock::now();
+        result.ok = planner.plan(cells, current, target, model, legacyMovesOnly, legacyMovesOnly, plan, error);
+        result.worstMs = max(result.worstMs, duration<double, milli>(steady_clock::now() - started).count());
+        if (!result.ok) {
+            result.detail = error;
+            return result;
+        }
+    }
+
+    BoardLayout replayed = current;
+    result.ok = applyPlan(cells, replayed, plan);
+    for (size_t i = 0; result.ok && i < cells.size(); i++) {
+        if (target[i] != LAYOUT_ANY && replayed[i] != target[i]) result.ok = false;
+    }
+    result.detail = to_string(plan.moves.size()) + " moves" + (plan.optimal ? "" : " (weighted)") +
+        (result.ok ? "" : ", plan does not reach the target");
+    return result;
+}
+
+void printUsage() {
+    cout << "Usage: bench_planner [--repeat <n>]" << endl;
+}
+
+int main(int argc, char** argv) {
+    int repeat = 3;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    bool allPlanned = true;
+    report("transfer 3x3 reset", transferCase(3, 3, 3, 1, repeat), allPlanned);
+    report("transfer 4x6 reset", transferCase(4, 6, 6, 1, repeat), allPlanned);
+    report("transfer 6x4 reset", transferCase(6, 4, 4, 1, repeat), allPlanned);
+    report("transfer 4x6 crowded", crowdedTransferCase(4, 6, repeat), allPlanned);
+    report("transfer 8x8 crowded", crowdedTransferCase(8, 8, repeat), allPlanned);
+
+    // 3x3: column 1 full, move it to column 3 with the legacy moves only
+    report("layout 3x3 legacy", layoutCase(3, 3,
+        { 1, 0, 0, 2, 0, 0, 3, 0, 0 },
+        { 0, 0, 1, 0, 0, 2, 0, 0, 3 }, true, repeat), allPlanned);
+
+    // 4x6: six blocks in column 1 reversed and spread out
+    BoardLayout current46(24, 0), target46(24, 0);
+    int colours[4] = { 1, 2, 3, 1 };
+    for (int row = 0; row < 4; row++) {
+        current46[row * 6] = colours[row];
+        target46[row * 6 + 5] = colours[3 - row];
+    }
+    current46[1] = 2;
+    current46[7] = 3;
+    target46[2] = 3;
+    target46[15] = 2;
+    report("layout 4x6 six blocks", layoutCase(4, 6, current46, target46, false, repeat), allPlanned);
+
+    // 4x6: twelve blocks mirrored left to right; needs the weighted fallback
+    BoardLayout mirrorCurrent(24, 0), mirrorTarget(24, 0);
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 3; col++) {
+            int colour = 1 + (row + col) % 3;
+            mirrorCurrent[row * 6 + col] = colour;
+            mirrorTarget[row * 6 + 5 - col] = colour;
+        }
+    }
+    report("layout 4x6 mirror", layoutCase(4, 6, mirrorCurrent, mirrorTarget, false, repeat), allPlanned);
+
+    return allPlanned ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "colour_classifier.hpp"
+#include "board_calibration.hpp"
+#include "board_vision.hpp"
+#include "board_rectifier.hpp"
+#include "stage_profiler.hpp"
+
+// Offline replay benchmark: runs the final.cpp vision pipeline over a recorded video or
+// image sequence as fast as possible, with no windows, and reports frames per second,
+// per-stage latency and the colour read for every space on every frame.
+//
+// Usage: bench_replay <video | image pattern> [options]
+//   video           any file VideoCapture can open, or a printf pattern such as frames/%04d.png
+//   image pattern   a glob such as "frames/*.png"; files are read in sorted order
+//   --calibration <file>  use a saved board_calibration.bin instead of calibrating on frame 0
+//   --board <rows>x<cols> board size (default 3x3)
+//   --max-frames <n>      stop after n frames
+//   --results <file>      per-frame classification CSV (default replay_results.csv)
+//   --latency <file>      append the stage summary to this CSV as well
+
+using namespace cv;
+using namespace std;
+using namespace std::chrono;
+
+// Reads frames from a video/printf pattern through VideoCapture or from a glob of images
+class ReplaySource {
+public:
+    bool open(const string& source) {
+        if (source.find('*') != string::npos) {
+            glob(source, files, false);
+            next = 0;
+            return !files.empty();
+        }
+        return cap.open(source) && cap.isOpened();
+    }
+
+    bool read(Mat& frame) {
+        if (!files.empty()) {
+            if (next >= files.size()) return false;
+            frame = imread(files[next++], IMREAD_COLOR);
+            return !frame.empty();
+        }
+        return cap.read(frame) && !frame.empty();
+    }
+
+private:
+    VideoCapture cap;
+    vector<String> files;
+    size_t next = 0;
+};
+
+void printUsage() {
+    cout << "Usage: bench_replay <video | image pattern> [--calibration <file>] [--board <rows>x<cols>]"
+        << " [--max-frames <n>] [--results <file>] [--latency <file>]" << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    string source = argv[1];
+    string calibrationFile;
+    string resultsFile = "replay_results.csv";
+    string latencyFile;
+    long maxFrames = -1;
+    BoardGeometry board;
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--calibration" && i + 1 < argc) {
+            calibrationFile = argv[++i];
+        }
+        else if (arg == "--board" && i + 1 < argc) {
+            if (!parseBoardGeometry(argv[++i], board)) {
+                cout << "Bad board size: " << argv[i] << " (use <rows>x<cols>, at most "
+                    << MAX_BOARD_SPACES << " spaces)" << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--max-frames" && i + 1 < argc) {
+            maxFrames = atol(argv[++i]);
+        }
+        else if (arg == "--results" && i + 1 < argc) {
+            resultsFile = argv[++i];
+        }
+        else if (arg == "--latency" && i + 1 < argc) {
+            latencyFile = argv[++i];
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    ReplaySource replay;
+    if (!replay.open(source)) {
+        cout << "Cannot open " << source << endl;
+        return 1;
+    }
+
+    Mat frame;
+    if (!replay.read(frame)) {
+        cout << "No frames in " << source << endl;
+        return 1;
+    }
+
+    // Same classifier set-up as the live program
+    ColourLUT colourLUT;
+    SpaceColourClassifier spaceClassifier;
+    BoardCalibration calibration;
+
+    auto calibrationStart = steady_clock::now();
+    if (!calibrationFile.empty()) {
+        if (!loadCalibration(calibrationFile, calibration)) {
+            cout << "Cannot load calibration from " << calibrationFile << endl;
+            return 1;
+        }
+        if (calibration.frameSize != frame.size()) {
+            cout << "Calibration frame size does not match the recording" << endl;
+            return 1;
+        }
+        if (!calibrationFitsBoard(calibration, board)) {
+            cout << "Calibration is not for a " << board.rows << "x" << board.cols << " board" << endl;
+            return 1;
+        }
+    }
+    else {
+        Mat calibrationFrame = frame.clone();
+        if (!calibrateFromFrame(calibrationFrame, colourLUT, calibration, board)) {
+            cout << "No spaces detected in the first frame; record an empty board first or pass --calibration" << endl;
+            return 1;
+        }
+    }
+
+    // Colours are sampled from the top-down board view, as in the live program
+    BoardRectifier rectifier;
+    rectifier.calibrate(calibration.boardContour);
+    vector<Point2f> centres;
+    for (size_t i = 0; i < calibration.spaces.size(); i++) {
+        centres.push_back(rectifier.ready() ? rectifier.project(calibration.spaces[i].center) : calibration.spaces[i].center);
+    }
+    spaceClassifier.calibrate(centres, rectifier.ready() ? rectifier.boardSize() : calibration.frameSize);
+    double calibrationMs = duration<double, milli>(steady_clock::now() - calibrationStart).count();
+    cout << "Calibrated " << calibration.spaces.size() << " spaces in " << calibrationMs << " ms" << endl;
+
+    ofstream results(resultsFile);
+    if (!results) {
+        cout << "Cannot write " << resultsFile << endl;
+        return 1;
+    }
+    results << "frame,board_found,spaces_found";
+    for (size_t i = 0; i < calibration.spaces.size(); i++) {
+        results << ",pos" << calibration.spaces[i].position_id << ",conf" << calibration.spaces[i].position_id;
+    }
+    results << "\n";
+
+    // A large window so the percentiles cover the whole of a typical recording
+    StageProfiler profiler(1 << 16);
+    const int STAGE_DECODE = profiler.addStage("decode");
+    const int STAGE_RECTIFY = profiler.addStage("rectify");
+    const int STAGE_CLASSIFY = profiler.addStage("classify");
+    const int STAGE_THRESHOLD = profiler.addStage("threshold");
+    const int STAGE_BOARD = profiler.addStage("detect board");
+    const int STAGE_SPACES = profiler.addStage("detect spaces");
+    const int STAGE_FRAME = profiler.addStage("frame total");
+
+    vector<SpaceReading> readings;
+    Mat imgThresholded, rectifiedBoard;
+    long frames = 0;
+    long boardLost = 0;
+    long spaceCountChanged = 0;
+    long uncertainReadings = 0;
+    double processingMs = 0;
+    bool haveFrame = true; // The first frame has already been decoded
+    auto runStart = steady_clock::now();
+
+    while (maxFrames < 0 || frames < maxFrames) {
+        auto frameStart = StageProfiler::Clock::now();
+        if (!haveFrame) {
+            StageProfiler::Scope timer(profiler, STAGE_DECODE);
+            if (!replay.read(frame)) break;
+        }
+        haveFrame = false;
+
+        if (frame.size() != calibration.frameSize) {
+            cout << "Frame " << frames << " has a different size; stopping" << endl;
+            break;
+        }
+
+        // Classify before detectBoard draws the board outline onto the frame
+        if (rectifier.ready()) {
+            StageProfiler::Scope timer(profiler, STAGE_RECTIFY);
+            rectifier.rectify(frame, rectifiedBoard);
+        }
+        {
+            StageProfiler::Scope timer(profiler, STAGE_CLASSIFY);
+            spaceClassifier.classify(rectifier.ready() ? rectifiedBoard : frame, colourLUT, readings);
+        }
+        {
+            StageProfiler::Scope timer(profiler, STAGE_THRESHOLD);
+            thresholdBoard(frame, colourLUT, imgThresholded);
+        }
+        vector<Point> boardContour;
+        {
+            StageProfiler::Scope timer(profiler, STAGE_BOARD);
+            boardContour = detectBoard(imgThresholded, frame);
+        }
+        vector<Space> spaces;
+        {
+            StageProfiler::Scope timer(profiler, STAGE_SPACES);
+            spaces = detectSpacesInBoard(imgThresholded, frame, boardContour);
+        }
+        auto frameEnd = StageProfiler::Clock::now();
+        profiler.record(STAGE_FRAME, frameStart, frameEnd);
+        processingMs += duration<double, milli>(frameEnd - frameStart).count();
+
+        // Bookkeeping and output stay outside the timed stages
+        if (boardContour.empty()) boardLost++;
+        if (spaces.size() != calibration.spaces.size()) spaceCountChanged++;
+
+        results << frames << "," << (boardContour.empty() ? 0 : 1) << "," << spaces.size();
+        for (size_t i = 0; i < readings.size(); i++) {
+            if (readings[i].colour == COLOUR_UNCERTAIN) uncertainReadings++;
+            results << "," << readings[i].colour << "," << readings[i].confidence;
+        }
+        results << "\n";
+        frames++;
+    }
+
+    double wallMs = duration<double, milli>(steady_clock::now() - runStart).count();
+    if (frames == 0) {
+        cout << "No frames processed" << endl;
+        return 1;
+    }
+
+    cout << "Frames:              " << frames << endl;
+    cout << "Pipeline fps:        " << frames * 1000.0 / processingMs << endl;
+    cout << "Wall-clock fps:      " << frames * 1000.0 / wallMs << endl;
+    cout << "Board lost:          " << boardLost << " frames" << endl;
+    cout << "Space count changed: " << spaceCountChanged << " frames" << endl;
+    cout << "Uncertain readings:  " << uncertainReadings << endl;
+    cout << endl;
+    cout << "stage           min   mean    p95    p99" << endl;
+    for (int i = 0; i < (int)profiler.stageCount(); i++) {
+        cout << profiler.describe(i) << endl;
+    }
+    cout << endl << "Per-frame classifications written to " << resultsFile << endl;
+
+    if (!latencyFile.empty() && !profiler.appendCsv(latencyFile)) {
+        cout << "Warning: Could not write " << latencyFile << endl;
+    }
+
+    return 0;
+}
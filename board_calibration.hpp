@@ -0,0 +1,159 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "board_tables.hpp"
+
+// Structure to store space information
+struct Space {
+    cv::Point2f center;
+    double area;
+    int colour;
+    double confidence; // Share of the sampled disc that agreed on the colour
+    int row;
+    int col;
+    int position_id; // (row - 1) * cols + col, 1-9 on the 3x3 board
+};
+
+// Everything captureEmptyFrame works out from an empty board
+struct BoardCalibration {
+    cv::Size frameSize;
+    std::vector<cv::Point> boardContour;
+    std::vector<Space> spaces;
+    int outliers = 0; // Detections the grid fit dropped (not saved)
+    int inferred = 0; // Spaces the grid fit added where nothing was detected (not saved)
+};
+
+// Compact binary calibration file, written in native byte order:
+//   "RSDC", version, frame width/height, contour point count, contour points,
+//   space count, then centre x/y, area, row, col, position_id for each space
+const char CALIBRATION_MAGIC[4] = { 'R', 'S', 'D', 'C' };
+const uint32_t CALIBRATION_VERSION = 1;
+
+namespace calibration_detail {
+    template<typename T>
+    void put(std::ofstream& out, T value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool get(std::ifstream& in, T& value) {
+        return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+}
+
+// Writes the calibration to disk; returns false if the file could not be written
+inline bool saveCalibration(const std::string& path, const BoardCalibration& calibration) {
+    using namespace calibration_detail;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(CALIBRATION_MAGIC, sizeof(CALIBRATION_MAGIC));
+    put<uint32_t>(out, CALIBRATION_VERSION);
+    put<int32_t>(out, calibration.frameSize.width);
+    put<int32_t>(out, calibration.frameSize.height);
+
+    put<uint32_t>(out, (uint32_t)calibration.boardContour.size());
+    for (const cv::Point& p : calibration.boardContour) {
+        put<int32_t>(out, p.x);
+        put<int32_t>(out, p.y);
+    }
+
+    put<uint32_t>(out, (uint32_t)calibration.spaces.size());
+    for (const Space& space : calibration.spaces) {
+        put<float>(out, space.center.x);
+        put<float>(out, space.center.y);
+        put<double>(out, space.area);
+        put<int32_t>(out, space.row);
+        put<int32_t>(out, space.col);
+        put<int32_t>(out, space.position_id);
+    }
+    return (bool)out;
+}
+
+// Reads a calibration written by saveCalibration; returns false for a missing or malformed file
+inline bool loadCalibration(const std::string& path, BoardCalibration& calibration) {
+    using namespace calibration_detail;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(CALIBRATION_MAGIC)];
+    uint32_t version = 0;
+    int32_t width = 0, height = 0;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, CALIBRATION_MAGIC, sizeof(magic)) != 0) return false;
+    if (!get(in, version) || version != CALIBRATION_VERSION) return false;
+    if (!get(in, width) || !get(in, height) || width <= 0 || height <= 0) return false;
+
+    BoardCalibration loaded;
+    loaded.frameSize = cv::Size(width, height);
+
+    uint32_t contourCount = 0;
+    if (!get(in, contourCount) || contourCount > 100000) return false;
+    for (uint32_t i = 0; i < contourCount; i++) {
+        int32_t x, y;
+        if (!get(in, x) || !get(in, y)) return false;
+        loaded.boardContour.push_back(cv::Point(x, y));
+    }
+
+    uint32_t spaceCount = 0;
+    if (!get(in, spaceCount) || spaceCount > 1024) return false;
+    for (uint32_t i = 0; i < spaceCount; i++) {
+        Space space = Space();
+        int32_t row, col, position_id;
+        if (!get(in, space.center.x) || !get(in, space.center.y) || !get(in, space.area) ||
+            !get(in, row) || !get(in, col) || !get(in, position_id)) {
+            return false;
+        }
+        space.row = row;
+        space.col = col;
+        space.position_id = position_id;
+        loaded.spaces.push_back(space);
+    }
+
+    calibration = loaded;
+    return true;
+}
+
+// Checks that a stored calibration was made for a board of this shape: one space per
+// position and every row, column and position_id inside it
+inline bool calibrationFitsBoard(const BoardCalibration& calibration, const BoardGeometry& board) {
+    if ((int)calibration.spaces.size() != board.spaces()) return false;
+    std::vector<bool> seen(board.spaces() + 1, false);
+    for (const Space& space : calibration.spaces) {
+        int id = board.positionId(space.row, space.col);
+        if (id < 0 || id != space.position_id || seen[id]) return false;
+        seen[id] = true;
+    }
+    return true;
+}
+
+// Checks that a board contour found in a live frame still matches the stored calibration:
+// same frame size, board centroid within maxShift pixels, area within maxAreaChange, and
+// every stored space centre still on the board. Works with blocks on the board, since it
+// only looks at the outline of the dark board.
+inline bool calibrationMatchesBoard(const BoardCalibration& calibration, cv::Size frameSize,
+    const std::vector<cv::Point>& liveContour, double maxShift = 15.0, double maxAreaChange = 0.1) {
+    if (frameSize != calibration.frameSize) return false;
+    if (liveContour.empty() || calibration.boardContour.empty()) return false;
+
+    cv::Moments stored = cv::moments(calibration.boardContour);
+    cv::Moments live = cv::moments(liveContour);
+    if (stored.m00 <= 0 || live.m00 <= 0) return false;
+
+    cv::Point2d storedCentre(stored.m10 / stored.m00, stored.m01 / stored.m00);
+    cv::Point2d liveCentre(live.m10 / live.m00, live.m01 / live.m00);
+    if (cv::norm(storedCentre - liveCentre) > maxShift) return false;
+
+    double areaChange = std::abs(live.m00 - stored.m00) / stored.m00;
+    if (areaChange > maxAreaChange) return false;
+
+    for (const Space& space : calibration.spaces) {
+        if (cv::pointPolygonTest(liveContour, space.center, false) < 0) return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <vector>
+#include "board_vision.hpp"
+
+// Warps the board region of a camera frame into a fixed size x size top-down image. The
+// per-pixel source coordinates are worked out once per calibration and kept as fixed-point
+// remap tables, so each live frame costs one small remap whatever the camera resolution,
+// and colour sampling afterwards always runs on the same tiny image.
+class BoardRectifier {
+public:
+    explicit BoardRectifier(int side = RECTIFIED_BOARD_SIZE) : size(side) {}
+
+    // Builds the remap tables from the board outline; returns false if it has no usable corners
+    bool calibrate(const std::vector<cv::Point>& boardContour) {
+        std::vector<cv::Point2f> corners;
+        if (!findBoardCorners(boardContour, corners)) {
+            clear();
+            return false;
+        }
+        calibrate(corners);
+        return true;
+    }
+
+    // Builds the remap tables from the four board corners (top-left, top-right, bottom-right, bottom-left)
+    void calibrate(const std::vector<cv::Point2f>& corners) {
+        toBoard = boardToRectified(corners, size);
+        cv::Matx33d toImage = toBoard.inv();
+
+        cv::Mat mapX(size, size, CV_32FC1), mapY(size, size, CV_32FC1);
+        for (int y = 0; y < size; y++) {
+            float* xs = mapX.ptr<float>(y);
+            float* ys = mapY.ptr<float>(y);
+            for (int x = 0; x < size; x++) {
+                cv::Point2f source = projectPoint(toImage, cv::Point2f((float)x, (float)y));
+                xs[x] = source.x;
+                ys[x] = source.y;
+            }
+        }
+        // Fixed-point tables make remap noticeably cheaper than float coordinates
+        cv::convertMaps(mapX, mapY, mapXY, mapFraction, CV_16SC2);
+    }
+
+    void clear() {
+        mapXY.release();
+        mapFraction.release();
+    }
+
+    bool ready() const {
+        return !mapXY.empty();
+    }
+
+    // Writes the top-down board view of 'frame' into 'board' (size x size, same type as frame)
+    void rectify(const cv::Mat& frame, cv::Mat& board) const {
+        cv::remap(frame, board, mapXY, mapFraction, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+    }
+
+    // Image point in top-down board coordinates
+    cv::Point2f project(const cv::Point2f& point) const {
+        return projectPoint(toBoard, point);
+    }
+
+    cv::Size boardSize() const {
+        return cv::Size(size, size);
+    }
+
+private:
+    int size;
+    cv::Matx33d toBoard;
+    cv::Mat mapXY, mapFraction;
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+// Grid and command encoding tables for the 3x3 board, built at compile time so every program
+// shares one definition and a lookup is a bounds check plus an array index. The single-byte
+// commands only exist for this board; other board shapes are described by BoardGeometry
+// below and driven with the framed protocol.
+//
+//   position_id        (row - 1) * 3 + col
+//   pick/place byte    ((pick_row - 1) << 4 | (place_row - 1)) + 1, C1 -> C3
+//   reset byte         128 + (pick_row - 1) * 4 + place_row, C3 -> C1
+//
+// Rows and columns are 1-based; index 0 of each table is unused. Invalid lookups return -1
+// for positions and 0 (the "clear" byte) for commands.
+const int BOARD_ROWS = 3;
+const int BOARD_COLS = 3;
+const int BOARD_SPACES = BOARD_ROWS * BOARD_COLS;
+
+const unsigned char CMD_CLEAR = 0;
+const unsigned char CMD_HOME = 64;
+
+namespace board_tables_detail {
+    struct Tables {
+        int position[BOARD_ROWS + 1][BOARD_COLS + 1];
+        unsigned char pickPlace[BOARD_ROWS + 1][BOARD_ROWS + 1];
+        unsigned char reset[BOARD_ROWS + 1][BOARD_ROWS + 1];
+    };
+
+    constexpr Tables build() {
+        Tables tables = {};
+        for (int row = 0; row <= BOARD_ROWS; row++) {
+            for (int col = 0; col <= BOARD_COLS; col++) {
+                tables.position[row][col] = (row >= 1 && col >= 1) ? (row - 1) * BOARD_COLS + col : -1;
+            }
+        }
+        for (int pick = 1; pick <= BOARD_ROWS; pick++) {
+            for (int place = 1; place <= BOARD_ROWS; place++) {
+                tables.pickPlace[pick][place] = (unsigned char)((((pick - 1) << 4) | (place - 1)) + 1);
+                tables.reset[pick][place] = (unsigned char)(128 + (pick - 1) * 4 + place);
+            }
+        }
+        return tables;
+    }
+
+    constexpr Tables TABLES = build();
+
+    constexpr const char* COLOUR_NAMES[] = { "Uncertain", "None", "Red", "Blue", "Green" };
+
+    constexpr bool validRow(int row) {
+        return row >= 1 && row <= BOARD_ROWS;
+    }
+
+    constexpr bool validCol(int col) {
+        return col >= 1 && col <= BOARD_COLS;
+    }
+
+    // Every command byte must decode back to the rows it was built from, must not collide
+    // with another command or with home/clear, and must fit the controller's ranges
+    constexpr bool commandsValid() {
+        for (int pick = 1; pick <= BOARD_ROWS; pick++) {
+            for (int place = 1; place <= BOARD_ROWS; place++) {
+                int move = TABLES.pickPlace[pick][place];
+                int reset = TABLES.reset[pick][place];
+                if (move < 1 || move >= CMD_HOME) return false;
+                if (reset <= 128 || reset > 255) return false;
+                if (((move - 1) >> 4) + 1 != pick || ((move - 1) & 0x0F) + 1 != place) return false;
+                if ((reset - 129) / 4 + 1 != pick || reset - 128 - (pick - 1) * 4 != place) return false;
+
+                for (int otherPick = 1; otherPick <= BOARD_ROWS; otherPick++) {
+                    for (int otherPlace = 1; otherPlace <= BOARD_ROWS; otherPlace++) {
+                        if (otherPick == pick && otherPlace == place) continue;
+                        if (TABLES.pickPlace[otherPick][otherPlace] == move) return false;
+                        if (TABLES.reset[otherPick][otherPlace] == reset) return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr bool positionsValid() {
+        for (int row = 1; row <= BOARD_ROWS; row++) {
+            for (int col = 1; col <= BOARD_COLS; col++) {
+                int id = TABLES.position[row][col];
+                if (id < 1 || id > BOARD_SPACES) return false;
+                if ((id - 1) / BOARD_COLS + 1 != row || (id - 1) % BOARD_COLS + 1 != col) return false;
+            }
+        }
+        return true;
+    }
+}
+
+static_assert(BOARD_ROWS <= 16, "Pick/place bytes hold the row in four bits");
+static_assert(board_tables_detail::positionsValid(), "Position ids must cover 1..BOARD_SPACES once each");
+static_assert(board_tables_detail::commandsValid(), "Command bytes must be unique and decodable");
+static_assert(board_tables_detail::TABLES.pickPlace[3][3] == 35, "C1R3 -> C3R3 is byte 35");
+static_assert(board_tables_detail::TABLES.reset[1][1] == 129 && board_tables_detail::TABLES.reset[3][3] == 139,
+    "Reset bytes run from 129 to 139");
+
+// position_id for a row and column, or -1 off the board
+constexpr int boardPositionId(int row, int col) {
+    return (board_tables_detail::validRow(row) && board_tables_detail::validCol(col))
+        ? board_tables_detail::TABLES.position[row][col] : -1;
+}
+
+// Byte that moves a block from column 1 of pickRow to column 3 of placeRow, or CMD_CLEAR
+constexpr unsigned char pickPlaceCode(int pickRow, int placeRow) {
+    return (board_tables_detail::validRow(pickRow) && board_tables_detail::validRow(placeRow))
+        ? board_tables_detail::TABLES.pickPlace[pickRow][placeRow] : CMD_CLEAR;
+}
+
+// Byte that moves a block from column 3 of pickRow back to column 1 of placeRow, or CMD_CLEAR
+constexpr unsigned char resetCode(int pickRow, int placeRow) {
+    return (board_tables_detail::validRow(pickRow) && board_tables_detail::validRow(placeRow))
+        ? board_tables_detail::TABLES.reset[pickRow][placeRow] : CMD_CLEAR;
+}
+
+// Display name for a colour code (-1 uncertain, 0 none, 1 red, 2 blue, 3 green)
+constexpr const char* colourName(int colourCode) {
+    return (colourCode >= -1 && colourCode <= 3) ? board_tables_detail::COLOUR_NAMES[colourCode + 1] : "Unknown";
+}
+
+// Largest board: framed position ids are one byte and 0 is not a position
+const int MAX_BOARD_SPACES = 255;
+
+// Rows and columns of the board in use, chosen at startup (e.g. --board 4x6). Numbering
+// follows the 3x3 board: position_id = (row - 1) * cols + col, columns counted from the right.
+struct BoardGeometry {
+    int rows = BOARD_ROWS;
+    int cols = BOARD_COLS;
+
+    int spaces() const {
+        return rows * cols;
+    }
+
+    bool contains(int row, int col) const {
+        return row >= 1 && row <= rows && col >= 1 && col <= cols;
+    }
+
+    // position_id for a row and column, or -1 off the board
+    int positionId(int row, int col) const {
+        return contains(row, col) ? (row - 1) * cols + col : -1;
+    }
+
+    // True when the single-byte commands can address every move on this board
+    bool legacyCommands() const {
+        return rows == BOARD_ROWS && cols == BOARD_COLS;
+    }
+};
+
+// Parses "<rows>x<cols>"; returns false for malformed text or a board with no valid ids
+inline bool parseBoardGeometry(const std::string& text, BoardGeometry& geometry) {
+    size_t split = text.find_first_of("xX");
+    if (split == std::string::npos || split == 0 || split + 1 >= text.size()) return false;
+    char* end = nullptr;
+    long rows = strtol(text.c_str(), &end, 10);
+    if (end != text.c_str() + split) return false;
+    long cols = strtol(text.c_str() + split + 1, &end, 10);
+    if (*end != '\0') return false;
+    if (rows < 1 || cols < 1 || rows > MAX_BOARD_SPACES || cols > MAX_BOARD_SPACES) return false;
+    if (rows * cols > MAX_BOARD_SPACES) return false;
+
+    geometry.rows = (int)rows;
+    geometry.cols = (int)cols;
+    return true;
+}
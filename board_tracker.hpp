@@ -0,0 +1,144 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "board_calibration.hpp"
+#include "board_vision.hpp"
+#include "colour_classifier.hpp"
+
+// Follows small bumps of the camera or board after calibration. Every 'interval' frames the
+// dark board outline is found again (it stays visible with blocks on it), its four corners are
+// matched to the calibrated ones and a similarity transform (shift, rotation, scale) is fitted.
+// The space centres are then re-projected from their calibrated positions, so errors never
+// accumulate. Outlines that do not fit well, or moved further than a bump would, are ignored.
+class BoardTracker {
+public:
+    int interval = 15;           // Frames between checks
+    double maxShiftPx = 60;      // Larger jumps mean the board was moved; recalibrate instead
+    double maxRotationDeg = 10;
+    double maxScaleChange = 0.15;
+    double maxResidualPx = 6;    // Mean corner error allowed after the fit
+    double minUpdatePx = 0.75;   // Smaller corrections are treated as noise
+
+    // Starts tracking from a calibration; returns false if the board outline has no usable corners
+    bool reset(const std::vector<cv::Point>& boardContour, const std::vector<Space>& spaces) {
+        referenceCentres.clear();
+        for (const Space& space : spaces) {
+            referenceCentres.push_back(space.center);
+        }
+        transform = cv::Matx23d(1, 0, 0, 0, 1, 0);
+        frames = 0;
+        corrections = 0;
+        rejected = 0;
+        tracking = findBoardCorners(boardContour, referenceCorners);
+        return tracking;
+    }
+
+    void stop() {
+        tracking = false;
+    }
+
+    // Feeds one live frame. On the frames it checks, updates the centres in 'spaces' (which
+    // must be in calibration order) and returns true when they moved.
+    bool update(const cv::Mat& frame, const ColourLUT& lut, std::vector<Space>& spaces) {
+        if (!tracking || spaces.size() != referenceCentres.size()) return false;
+        if (++frames % interval != 0) return false;
+
+        thresholdBoard(frame, lut, thresholded);
+        scratch.create(1, 1, CV_8UC3); // detectBoard draws the outline; nothing should see it
+        std::vector<cv::Point> contour = detectBoard(thresholded, scratch);
+
+        std::vector<cv::Point2f> corners;
+        cv::Matx23d fitted;
+        if (!findBoardCorners(contour, corners) || !fitSimilarity(referenceCorners, corners, fitted)) {
+            rejected++;
+            return false;
+        }
+
+        // Compare against the current correction at the board's corners before applying it
+        double change = 0;
+        for (const cv::Point2f& corner : referenceCorners) {
+            change = std::max(change, cv::norm(apply(fitted, corner) - apply(transform, corner)));
+        }
+        if (change < minUpdatePx) return false;
+
+        transform = fitted;
+        for (size_t i = 0; i < spaces.size(); i++) {
+            spaces[i].center = apply(transform, referenceCentres[i]);
+        }
+        corrections++;
+        return true;
+    }
+
+    // Current calibration-to-live correction
+    const cv::Matx23d& correction() const {
+        return transform;
+    }
+
+    // Board outline moved by the current correction
+    std::vector<cv::Point> correctedContour(const std::vector<cv::Point>& boardContour) const {
+        std::vector<cv::Point> moved;
+        for (const cv::Point& point : boardContour) {
+            moved.push_back(apply(transform, cv::Point2f((float)point.x, (float)point.y)));
+        }
+        return moved;
+    }
+
+    bool active() const {
+        return tracking;
+    }
+
+    unsigned long corrections = 0;
+    unsigned long rejected = 0; // Checks where the outline was missing or implausible
+
+private:
+    static cv::Point2f apply(const cv::Matx23d& m, const cv::Point2f& p) {
+        return cv::Point2f((float)(m(0, 0) * p.x + m(0, 1) * p.y + m(0, 2)),
+            (float)(m(1, 0) * p.x + m(1, 1) * p.y + m(1, 2)));
+    }
+
+    // Least-squares similarity transform from 'from' to 'to' (closed form, so no calib3d),
+    // rejected if it is not a plausible bump
+    bool fitSimilarity(const std::vector<cv::Point2f>& from, const std::vector<cv::Point2f>& to, cv::Matx23d& fitted) const {
+        cv::Point2d fromMean, toMean;
+        for (size_t i = 0; i < from.size(); i++) {
+            fromMean += cv::Point2d(from[i]);
+            toMean += cv::Point2d(to[i]);
+        }
+        fromMean *= 1.0 / from.size();
+        toMean *= 1.0 / to.size();
+
+        double dot = 0, cross = 0, spread = 0;
+        for (size_t i = 0; i < from.size(); i++) {
+            cv::Point2d a = cv::Point2d(from[i]) - fromMean, b = cv::Point2d(to[i]) - toMean;
+            dot += a.x * b.x + a.y * b.y;
+            cross += a.x * b.y - a.y * b.x;
+            spread += a.x * a.x + a.y * a.y;
+        }
+        if (spread <= 0) return false;
+
+        double c = dot / spread, s = cross / spread;
+        fitted = cv::Matx23d(c, -s, toMean.x - (c * fromMean.x - s * fromMean.y),
+            s, c, toMean.y - (s * fromMean.x + c * fromMean.y));
+
+        double scale = std::sqrt(fitted(0, 0) * fitted(0, 0) + fitted(1, 0) * fitted(1, 0));
+        double rotation = std::atan2(fitted(1, 0), fitted(0, 0)) * 180.0 / CV_PI;
+        if (std::fabs(scale - 1) > maxScaleChange || std::fabs(rotation) > maxRotationDeg) return false;
+
+        double residual = 0, shift = 0;
+        for (size_t i = 0; i < from.size(); i++) {
+            residual += cv::norm(apply(fitted, from[i]) - to[i]);
+            shift = std::max(shift, cv::norm(to[i] - from[i]));
+        }
+        return residual / from.size() <= maxResidualPx && shift <= maxShiftPx;
+    }
+
+    std::vector<cv::Point2f> referenceCorners;
+    std::vector<cv::Point2f> referenceCentres;
+    cv::Matx23d transform = cv::Matx23d(1, 0, 0, 0, 1, 0);
+    bool tracking = false;
+    unsigned long frames = 0;
+    cv::Mat thresholded, scratch;
+};
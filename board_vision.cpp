@@ -0,0 +1,203 @@
+#include "board_vision.hpp"
+#include <algorithm>
+
+void thresholdBoard(const cv::Mat& frame, const ColourLUT& lut, cv::Mat& thresholded) {
+    lut.darkMask(frame, thresholded);
+
+    static const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::morphologyEx(thresholded, thresholded, cv::MORPH_CLOSE, kernel);
+    cv::morphologyEx(thresholded, thresholded, cv::MORPH_OPEN, kernel);
+}
+
+std::vector<cv::Point> detectBoard(cv::Mat& thresholded, cv::Mat& original) {
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+
+    cv::findContours(thresholded, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    double maxArea = 0;
+    int maxAreaIdx = -1;
+
+    for (size_t i = 0; i < contours.size(); i++) {
+        double area = cv::contourArea(contours[i]);
+        if (area > maxArea) {
+            maxArea = area;
+            maxAreaIdx = (int)i;
+        }
+    }
+
+    if (maxAreaIdx >= 0 && maxArea > 10000) {
+        cv::drawContours(original, contours, maxAreaIdx, cv::Scalar(0, 255, 255), 3);
+        return contours[maxAreaIdx];
+    }
+
+    return std::vector<cv::Point>();
+}
+
+std::vector<Space> detectSpacesInBoard(cv::Mat& thresholded, cv::Mat& /*original*/,
+    const std::vector<cv::Point>& boardContour) {
+    std::vector<Space> spaces;
+
+    if (boardContour.empty()) return spaces;
+
+    cv::Mat boardMask = cv::Mat::zeros(thresholded.size(), CV_8UC1);
+    std::vector<std::vector<cv::Point>> boardContours = { boardContour };
+    cv::fillPoly(boardMask, boardContours, cv::Scalar(255));
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+
+    cv::Mat spacesImage;
+    cv::bitwise_not(thresholded, spacesImage);
+    cv::bitwise_and(spacesImage, boardMask, spacesImage);
+
+    cv::findContours(spacesImage, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    for (size_t i = 0; i < contours.size(); i++) {
+        double area = cv::contourArea(contours[i]);
+        if (area < 100 || area > 10000) continue;
+
+        cv::Point2f center;
+        float radius;
+        cv::minEnclosingCircle(contours[i], center, radius);
+
+        if (cv::pointPolygonTest(boardContour, center, false) >= 0) {
+            double perimeter = cv::arcLength(contours[i], true);
+            double circularity = 0;
+            if (perimeter > 0) {
+                circularity = (4 * CV_PI * area) / (perimeter * perimeter);
+            }
+
+            if (circularity > 0.5) {
+                Space space = Space();
+                space.center = center;
+                space.area = area;
+                space.colour = 0;
+                space.confidence = 0;
+                spaces.push_back(space);
+            }
+        }
+    }
+
+    return spaces;
+}
+
+bool findBoardCorners(const std::vector<cv::Point>& boardContour, std::vector<cv::Point2f>& corners) {
+    if (boardContour.size() < 4) return false;
+
+    std::vector<cv::Point> hull, polygon;
+    cv::convexHull(boardContour, hull);
+    cv::approxPolyDP(hull, polygon, 0.02 * cv::arcLength(hull, true), true);
+
+    std::vector<cv::Point2f> points;
+    if (polygon.size() == 4) {
+        for (const cv::Point& point : polygon) points.push_back(cv::Point2f((float)point.x, (float)point.y));
+    }
+    else {
+        cv::Point2f box[4];
+        cv::minAreaRect(hull).points(box);
+        points.assign(box, box + 4);
+    }
+
+    // Smallest x+y is top-left, largest is bottom-right; y-x picks the other two
+    corners.assign(4, cv::Point2f());
+    auto bySum = [](const cv::Point2f& a, const cv::Point2f& b) { return a.x + a.y < b.x + b.y; };
+    auto byDiff = [](const cv::Point2f& a, const cv::Point2f& b) { return a.y - a.x < b.y - b.x; };
+    corners[0] = *std::min_element(points.begin(), points.end(), bySum);
+    corners[2] = *std::max_element(points.begin(), points.end(), bySum);
+    corners[1] = *std::min_element(points.begin(), points.end(), byDiff);
+    corners[3] = *std::max_element(points.begin(), points.end(), byDiff);
+    return true;
+}
+
+cv::Matx33d boardToRectified(const std::vector<cv::Point2f>& corners, int size) {
+    float side = (float)(size - 1);
+    cv::Point2f square[4] = { cv::Point2f(0, 0), cv::Point2f(side, 0), cv::Point2f(side, side), cv::Point2f(0, side) };
+    return cv::Matx33d(cv::getPerspectiveTransform(corners.data(), square));
+}
+
+cv::Point2f projectPoint(const cv::Matx33d& homography, const cv::Point2f& point) {
+    double x = homography(0, 0) * point.x + homography(0, 1) * point.y + homography(0, 2);
+    double y = homography(1, 0) * point.x + homography(1, 1) * point.y + homography(1, 2);
+    double w = homography(2, 0) * point.x + homography(2, 1) * point.y + homography(2, 2);
+    return cv::Point2f((float)(x / w), (float)(y / w));
+}
+
+bool assignGridPositions(std::vector<Space>& spaces, const cv::Matx33d& toBoard, int rows, int cols, GridFit* report) {
+    std::vector<cv::Point2f> projected;
+    for (const Space& space : spaces) {
+        projected.push_back(projectPoint(toBoard, space.center));
+    }
+    // In the top-down view the spaces divide the rectified board evenly
+    cv::Size2d expectedPitch;
+    if (toBoard != cv::Matx33d::eye()) {
+        expectedPitch = cv::Size2d((double)RECTIFIED_BOARD_SIZE / cols, (double)RECTIFIED_BOARD_SIZE / rows);
+    }
+    GridFit fit;
+    if (!fitGrid(projected, rows, cols, fit, expectedPitch)) return false;
+
+    // Inferred spaces get the typical size of the detected ones
+    std::vector<double> areas;
+    for (const Space& space : spaces) {
+        areas.push_back(space.area);
+    }
+    std::nth_element(areas.begin(), areas.begin() + areas.size() / 2, areas.end());
+    double typicalArea = areas[areas.size() / 2];
+
+    std::vector<Space> fitted;
+    for (size_t i = 0; i < spaces.size(); i++) {
+        if (fit.rowOf[i] < 0) continue;
+        Space space = spaces[i];
+        space.row = fit.rowOf[i] + 1;
+        space.col = cols - fit.colOf[i];
+        fitted.push_back(space);
+    }
+    cv::Matx33d toImage = toBoard.inv();
+    for (size_t i = 0; i < fit.missing.size(); i++) {
+        Space space;
+        space.center = projectPoint(toImage, fit.missing[i]);
+        space.area = typicalArea;
+        space.colour = 0;
+        space.confidence = 0;
+        space.row = fit.missingCells[i].y + 1;
+        space.col = cols - fit.missingCells[i].x;
+        fitted.push_back(space);
+    }
+
+    for (Space& space : fitted) {
+        space.position_id = (space.row - 1) * cols + space.col;
+    }
+    // Top to bottom, left to right (columns count down from the left)
+    std::sort(fitted.begin(), fitted.end(), [](const Space& a, const Space& b) {
+        if (a.row != b.row) return a.row < b.row;
+        return a.col > b.col;
+        });
+    spaces = fitted;
+    if (report) *report = fit;
+    return true;
+}
+
+bool calibrateFromFrame(cv::Mat& frame, const ColourLUT& lut, BoardCalibration& calibration, const BoardGeometry& board) {
+    cv::Mat thresholded;
+    thresholdBoard(frame, lut, thresholded);
+
+    std::vector<cv::Point> boardContour = detectBoard(thresholded, frame);
+    std::vector<Space> spaces = detectSpacesInBoard(thresholded, frame, boardContour);
+    if (spaces.empty()) return false;
+
+    // Fit the grid in the top-down view when the board has clear corners
+    std::vector<cv::Point2f> corners;
+    cv::Matx33d toBoard = cv::Matx33d::eye();
+    if (findBoardCorners(boardContour, corners)) {
+        toBoard = boardToRectified(corners);
+    }
+    GridFit fit;
+    if (!assignGridPositions(spaces, toBoard, board.rows, board.cols, &fit)) return false;
+
+    calibration.outliers = fit.outliers;
+    calibration.inferred = (int)fit.missing.size();
+    calibration.frameSize = frame.size();
+    calibration.boardContour = boardContour;
+    calibration.spaces = spaces;
+    return true;
+}
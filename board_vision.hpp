@@ -0,0 +1,49 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <vector>
+#include "colour_classifier.hpp"
+#include "board_calibration.hpp"
+#include "board_tables.hpp"
+#include "grid_fit.hpp"
+
+// Board and space detection shared by every front end and the offline benchmarks; the
+// definitions live in board_vision.cpp, built into the board_vision library.
+// Everything here works on a single frame and keeps no state between calls.
+
+// Thresholds the dark board with the colour table and cleans up noise
+void thresholdBoard(const cv::Mat& frame, const ColourLUT& lut, cv::Mat& thresholded);
+
+// Finds the largest dark object (the board) and outlines it on 'original'
+std::vector<cv::Point> detectBoard(cv::Mat& thresholded, cv::Mat& original);
+
+// Finds the round light spaces inside the board contour
+std::vector<Space> detectSpacesInBoard(cv::Mat& thresholded, cv::Mat& original,
+    const std::vector<cv::Point>& boardContour);
+
+// Side of the square top-down board image the live path samples colours from
+const int RECTIFIED_BOARD_SIZE = 300;
+
+// Four corners of a board outline, ordered top-left, top-right, bottom-right, bottom-left.
+// Returns false for an outline too small to have corners.
+bool findBoardCorners(const std::vector<cv::Point>& boardContour, std::vector<cv::Point2f>& corners);
+
+// Homography from image coordinates to the size x size top-down board image
+cv::Matx33d boardToRectified(const std::vector<cv::Point2f>& corners, int size = RECTIFIED_BOARD_SIZE);
+
+// Applies a homography to one point
+cv::Point2f projectPoint(const cv::Matx33d& homography, const cv::Point2f& point);
+
+// Fits the spaces to a rows x cols grid (see grid_fit.hpp) and numbers them, sorted top to
+// bottom, left to right. Columns are numbered from the right, as seen from the robot.
+// Outliers are dropped and spaces the detector missed are added at their lattice position.
+// With a homography the fit runs in the top-down board view, so perspective and tilt do not
+// mix up the rows, and the lattice must have about the pitch of the rectified board divided
+// into rows x cols. Returns false, leaving 'spaces' alone, when no grid could be fitted.
+bool assignGridPositions(std::vector<Space>& spaces, const cv::Matx33d& toBoard = cv::Matx33d::eye(),
+    int rows = BOARD_ROWS, int cols = BOARD_COLS, GridFit* report = nullptr);
+
+// Runs the whole empty-board calibration on one frame: threshold, board, spaces, grid.
+// The board outline is drawn onto 'frame'. Returns false when no grid of spaces was found.
+bool calibrateFromFrame(cv::Mat& frame, const ColourLUT& lut, BoardCalibration& calibration,
+    const BoardGeometry& board = BoardGeometry());
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <vector>
+
+// Colour codes shared by every program (0=None, 1=Red, 2=Blue, 3=Green).
+// COLOUR_UNCERTAIN marks a space whose patch did not agree strongly enough on one class.
+enum ColourCode {
+    COLOUR_UNCERTAIN = -1,
+    COLOUR_NONE = 0,
+    COLOUR_RED = 1,
+    COLOUR_BLUE = 2,
+    COLOUR_GREEN = 3
+};
+
+const int COLOUR_CLASSES = 4; // None, Red, Blue, Green
+
+// Hue/saturation/value rules used to classify block colours and find the dark board.
+// Hue ranges are in OpenCV's 0-180 scale; a pixel must exceed both minimums to count as a block.
+struct ColourThresholds {
+    int hueLow[COLOUR_CLASSES] = { 0, 140, 100, 30 };
+    int hueHigh[COLOUR_CLASSES] = { 0, 180, 135, 80 };
+    int minSaturation = 100;
+    int minValue = 50;
+    int boardMaxValue = 100; // Pixels at or below this value belong to the dark board
+
+    // Classifies a single HSV pixel into a colour code
+    int classify(int hue, int saturation, int value) const {
+        if (saturation <= minSaturation || value <= minValue) return COLOUR_NONE;
+        for (int c = COLOUR_RED; c < COLOUR_CLASSES; c++) {
+            if (hue >= hueLow[c] && hue <= hueHigh[c]) return c;
+        }
+        return COLOUR_NONE;
+    }
+};
+
+// Quantised BGR -> colour class lookup table compiled from a set of ColourThresholds.
+// Each 8-bit channel is reduced to BITS bits, so classifying a pixel is a single table read
+// with no HSV conversion. The low bits of each entry hold the colour code and DARK_FLAG marks
+// bins that fall inside the board threshold used at calibration.
+class ColourLUT {
+public:
+    static const int BITS = 5;
+    static const int BINS = 1 << BITS;
+    static const int SHIFT = 8 - BITS;
+    static const unsigned char CLASS_MASK = 0x03;
+    static const unsigned char DARK_FLAG = 0x80;
+
+    ColourLUT() {
+        build(ColourThresholds());
+    }
+
+    // Recompiles the table; converts one BGR sample per bin (BINS^3 pixels) in a single call
+    void build(const ColourThresholds& newThresholds) {
+        thresholds = newThresholds;
+
+        cv::Mat binCentres(BINS * BINS, BINS, CV_8UC3);
+        for (int b = 0; b < BINS; b++) {
+            for (int g = 0; g < BINS; g++) {
+                cv::Vec3b* row = binCentres.ptr<cv::Vec3b>(b * BINS + g);
+                for (int r = 0; r < BINS; r++) {
+                    row[r] = cv::Vec3b((uchar)binCentre(b), (uchar)binCentre(g), (uchar)binCentre(r));
+                }
+            }
+        }
+
+        cv::Mat binHSV;
+        cv::cvtColor(binCentres, binHSV, cv::COLOR_BGR2HSV);
+
+        table.resize(BINS * BINS * BINS);
+        for (int i = 0; i < BINS * BINS; i++) {
+            const cv::Vec3b* row = binHSV.ptr<cv::Vec3b>(i);
+            for (int r = 0; r < BINS; r++) {
+                unsigned char entry = (unsigned char)thresholds.classify(row[r][0], row[r][1], row[r][2]);
+                if (row[r][2] <= thresholds.boardMaxValue) entry |= DARK_FLAG;
+                table[i * BINS + r] = entry;
+            }
+        }
+    }
+
+    const ColourThresholds& getThresholds() const {
+        return thresholds;
+    }
+
+    unsigned char entry(const cv::Vec3b& bgr) const {
+        return table[((bgr[0] >> SHIFT) << (2 * BITS)) | ((bgr[1] >> SHIFT) << BITS) | (bgr[2] >> SHIFT)];
+    }
+
+    // Classifies a single BGR pixel into a colour code
+    int classify(const cv::Vec3b& bgr) const {
+        return entry(bgr) & CLASS_MASK;
+    }
+
+    // Writes 255 for every pixel of the frame that falls inside the dark board threshold
+    void darkMask(const cv::Mat& frame, cv::Mat& mask) const {
+        mask.create(frame.size(), CV_8UC1);
+        for (int y = 0; y < frame.rows; y++) {
+            const cv::Vec3b* in = frame.ptr<cv::Vec3b>(y);
+            uchar* out = mask.ptr<uchar>(y);
+            for (int x = 0; x < frame.cols; x++) {
+                out[x] = (entry(in[x]) & DARK_FLAG) ? 255 : 0;
+            }
+        }
+    }
+
+private:
+    static int binCentre(int bin) {
+        return (bin << SHIFT) + (1 << (SHIFT - 1));
+    }
+
+    ColourThresholds thresholds;
+    std::vector<unsigned char> table;
+};
+
+// Result of classifying one space: the winning colour, the share of the disc that voted
+// for it, and the full per-class vote histogram
+struct SpaceReading {
+    int colour;
+    float confidence;
+    int votes[COLOUR_CLASSES];
+};
+
+// Classifies the colour of every calibrated space from a disc of pixels around its centre.
+// The patch rectangles and disc masks are worked out once at calibration time; each frame
+// every disc pixel is classified with one ColourLUT read and each space takes a majority
+// vote over its disc. Spaces whose winning class falls below minConfidence are reported
+// as COLOUR_UNCERTAIN rather than guessed.
+class SpaceColourClassifier {
+public:
+    // Radius of the disc sampled around each space centre
+    static const int PATCH_RADIUS = 5;
+    static const int PATCH_SIZE = 2 * PATCH_RADIUS + 1;
+
+    // Minimum share of disc pixels the winning class needs to be trusted
+    float minConfidence = 0.6f;
+
+    // Precomputes the patch rectangle and disc mask for each space centre within a frame of the given size
+    void calibrate(const std::vector<cv::Point2f>& centres, cv::Size size) {
+        frameSize = size;
+        patches.clear();
+        discs.clear();
+        discPixels.clear();
+
+        cv::Rect frameRect(0, 0, size.width, size.height);
+        for (size_t i = 0; i < centres.size(); i++) {
+            // Match the truncation used when the centre was passed as an int pixel
+            cv::Point centre((int)centres[i].x, (int)centres[i].y);
+            cv::Rect patch = cv::Rect(centre.x - PATCH_RADIUS, centre.y - PATCH_RADIUS,
+                PATCH_SIZE, PATCH_SIZE) & frameRect;
+            if (!frameRect.contains(centre)) {
+                patch = cv::Rect();
+            }
+
+            // Disc around the centre, clipped to the part of the patch inside the frame
+            cv::Mat disc = cv::Mat::zeros(patch.height, patch.width, CV_8UC1);
+            if (patch.area() > 0) {
+                cv::circle(disc, centre - patch.tl(), PATCH_RADIUS, cv::Scalar(255), cv::FILLED);
+            }
+
+            patches.push_back(patch);
+            discs.push_back(disc);
+            discPixels.push_back(patch.area() > 0 ? cv::countNonZero(disc) : 0);
+        }
+    }
+
+    bool isCalibrated() const {
+        return !patches.empty();
+    }
+
+    cv::Size calibratedSize() const {
+        return frameSize;
+    }
+
+    // Classifies every calibrated space in the frame, writing one reading per space
+    void classify(const cv::Mat& frame, const ColourLUT& lut, std::vector<SpaceReading>& readings) const {
+        SpaceReading empty = { COLOUR_NONE, 0.0f, { 0, 0, 0, 0 } };
+        readings.assign(patches.size(), empty);
+        if (patches.empty() || frame.size() != frameSize) return;
+
+        for (size_t i = 0; i < patches.size(); i++) {
+            if (discPixels[i] == 0) continue;
+            SpaceReading& reading = readings[i];
+
+            // One table read per disc pixel builds the vote histogram
+            const cv::Rect& patch = patches[i];
+            for (int y = 0; y < patch.height; y++) {
+                const cv::Vec3b* pixels = frame.ptr<cv::Vec3b>(patch.y + y) + patch.x;
+                const uchar* mask = discs[i].ptr<uchar>(y);
+                for (int x = 0; x < patch.width; x++) {
+                    if (mask[x]) reading.votes[lut.classify(pixels[x])]++;
+                }
+            }
+
+            int winner = COLOUR_NONE;
+            for (int c = COLOUR_RED; c < COLOUR_CLASSES; c++) {
+                if (reading.votes[c] > reading.votes[winner]) winner = c;
+            }
+
+            reading.confidence = (float)reading.votes[winner] / discPixels[i];
+            reading.colour = (reading.confidence >= minConfidence) ? winner : COLOUR_UNCERTAIN;
+        }
+    }
+
+private:
+    cv::Size frameSize;
+    std::vector<cv::Rect> patches; // Patch rectangle in frame coordinates (empty when off-frame)
+    std::vector<cv::Mat> discs;    // Disc mask for each patch
+    std::vector<int> discPixels;   // Number of disc pixels inside the frame for each space
+};
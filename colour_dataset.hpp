@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "board_calibration.hpp"
+
+// Labelled colour dataset used to score classifiers offline. A dataset is a directory with:
+//   board_calibration.bin  space centres, in the same format final.cpp saves
+//   labels.csv             header "image,<position_id>,<position_id>,...", then one line per
+//                          frame: the image file name (relative to the directory) followed by
+//                          the expected colour code of each listed position
+//   the image files themselves
+const std::string DATASET_CALIBRATION = "board_calibration.bin";
+const std::string DATASET_LABELS = "labels.csv";
+
+struct LabelledFrame {
+    std::string image;
+    std::vector<int> expected; // One colour code per entry of ColourDataset::positions
+};
+
+struct ColourDataset {
+    BoardCalibration calibration;
+    std::vector<int> positions; // position_id of each label column
+    std::vector<LabelledFrame> frames;
+};
+
+namespace dataset_detail {
+    // Parses a whole field as an integer; rejects empty or trailing text
+    inline bool parseInt(const std::string& text, int& value) {
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0') return false;
+        value = (int)parsed;
+        return true;
+    }
+}
+
+// Writes labels.csv and the calibration; the images are written by whoever made the frames
+inline bool saveDataset(const std::string& dir, const ColourDataset& dataset) {
+    if (!saveCalibration(dir + "/" + DATASET_CALIBRATION, dataset.calibration)) return false;
+
+    std::ofstream out(dir + "/" + DATASET_LABELS, std::ios::trunc);
+    if (!out) return false;
+    out << "image";
+    for (int position : dataset.positions) out << "," << position;
+    out << "\n";
+    for (const LabelledFrame& frame : dataset.frames) {
+        out << frame.image;
+        for (int colour : frame.expected) out << "," << colour;
+        out << "\n";
+    }
+    return (bool)out;
+}
+
+// Reads a dataset directory; returns false if the calibration or labels are missing or malformed
+inline bool loadDataset(const std::string& dir, ColourDataset& dataset) {
+    ColourDataset loaded;
+    if (!loadCalibration(dir + "/" + DATASET_CALIBRATION, loaded.calibration)) return false;
+
+    std::ifstream in(dir + "/" + DATASET_LABELS);
+    std::string line, field;
+    if (!in || !std::getline(in, line)) return false;
+
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    std::stringstream header(line);
+    std::getline(header, field, ','); // "image"
+    int value;
+    while (std::getline(header, field, ',')) {
+        if (!dataset_detail::parseInt(field, value)) return false;
+        loaded.positions.push_back(value);
+    }
+    if (loaded.positions.empty()) return false;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        std::stringstream row(line);
+        LabelledFrame frame;
+        std::getline(row, frame.image, ',');
+        while (std::getline(row, field, ',')) {
+            if (!dataset_detail::parseInt(field, value)) return false;
+            frame.expected.push_back(value);
+        }
+        if (frame.expected.size() != loaded.positions.size()) return false;
+        loaded.frames.push_back(frame);
+    }
+
+    dataset = loaded;
+    return true;
+}
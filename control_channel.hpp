@@ -0,0 +1,55 @@
+#pragma once
+
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Line-based command channel for running without windows. A background thread reads
+// lines from a stream (stdin by default, so commands can come from a terminal, a pipe or
+// a FIFO) and the main loop picks them up with poll() without ever blocking on input.
+class ControlChannel {
+public:
+    ControlChannel() : state(std::make_shared<State>()) {}
+
+    // Starts reading lines in the background. The reader is detached because a blocking
+    // read on stdin cannot be interrupted; it only touches the shared state it owns.
+    void start(std::istream& in = std::cin) {
+        std::shared_ptr<State> shared = state;
+        std::thread([shared, &in] {
+            std::string line;
+            while (std::getline(in, line)) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->lines.push_back(line);
+            }
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->closed = true;
+        }).detach();
+    }
+
+    // Takes the next waiting command line, if any
+    bool poll(std::string& line) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->lines.empty()) return false;
+        line = state->lines.front();
+        state->lines.pop_front();
+        return true;
+    }
+
+    // True once the input stream has ended
+    bool closed() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->closed && state->lines.empty();
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::deque<std::string> lines;
+        bool closed = false;
+    };
+
+    std::shared_ptr<State> state;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <functional>
+#include <map>
+#include <vector>
+
+// Retained-mode control panel. Static text and decoration are drawn once into a background
+// image; each widget owns a rectangle of the panel and is only redrawn when the state value it
+// is given changes. A widget's rendered bitmaps are cached per state, so flipping a button back
+// and forth is a copy rather than a redraw, and render() reports whether anything changed so
+// the caller can skip imshow on frames where the panel is unchanged.
+class ControlPanel {
+public:
+    // Draws a widget onto the panel, in panel coordinates; it must stay inside its area
+    typedef std::function<void(cv::Mat& panel)> DrawFunction;
+
+    ControlPanel(cv::Size size, const cv::Scalar& colour) : backgroundImage(size, CV_8UC3, colour) {}
+
+    // Canvas for static content; draw everything that never changes here before the first render
+    cv::Mat& background() {
+        return backgroundImage;
+    }
+
+    // Registers a widget covering 'area' and returns its index
+    int addWidget(const cv::Rect& area, DrawFunction draw) {
+        Widget widget;
+        widget.area = area & cv::Rect(0, 0, backgroundImage.cols, backgroundImage.rows);
+        widget.draw = draw;
+        widgets.push_back(widget);
+        return (int)widgets.size() - 1;
+    }
+
+    // Sets the value the widget's appearance depends on; the widget is redrawn only when it changes
+    void setState(int widget, long long state) {
+        Widget& w = widgets[widget];
+        if (w.drawn && w.state == state) return;
+        w.state = state;
+        w.dirty = true;
+    }
+
+    // Forces every widget and the background to be drawn again, e.g. after the window was recreated
+    void invalidate() {
+        backgroundDrawn = false;
+        for (Widget& widget : widgets) {
+            widget.dirty = true;
+        }
+    }
+
+    // Brings the panel image up to date; returns true if any pixels changed
+    bool render() {
+        bool changed = false;
+        if (!backgroundDrawn) {
+            backgroundImage.copyTo(panel);
+            backgroundDrawn = true;
+            changed = true;
+        }
+
+        for (Widget& widget : widgets) {
+            if (!widget.dirty) continue;
+            cv::Mat target = panel(widget.area);
+            auto cached = widget.bitmaps.find(widget.state);
+            if (cached != widget.bitmaps.end()) {
+                cached->second.copyTo(target);
+            }
+            else {
+                backgroundImage(widget.area).copyTo(target);
+                widget.draw(panel);
+                if (widget.bitmaps.size() >= MAX_CACHED_STATES) widget.bitmaps.clear();
+                widget.bitmaps[widget.state] = target.clone();
+            }
+            widget.dirty = false;
+            widget.drawn = true;
+            changed = true;
+        }
+        return changed;
+    }
+
+    const cv::Mat& image() const {
+        return panel;
+    }
+
+private:
+    static const size_t MAX_CACHED_STATES = 8;
+
+    struct Widget {
+        cv::Rect area;
+        DrawFunction draw;
+        long long state = 0;
+        bool dirty = true;
+        bool drawn = false;
+        std::map<long long, cv::Mat> bitmaps;
+    };
+
+    cv::Mat backgroundImage;
+    cv::Mat panel;
+    bool backgroundDrawn = false;
+    std::vector<Widget> widgets;
+};
@@ -8,363 +8,540 @@
 #include <map>
 #include <thread>
 #include <chrono>
-
-#define BAUD 9600
+#include <csignal>
+#include <sstream>
+#include "colour_classifier.hpp"
+#include "frame_grabber.hpp"
+#include "robot_queue.hpp"
+#include "move_verifier.hpp"
+#include "board_calibration.hpp"
+#include "control_channel.hpp"
+#include "stage_profiler.hpp"
+#include "board_vision.hpp"
+#include "serial_config.hpp"
+#include "move_planner.hpp"
+#include "board_tables.hpp"
+#include "control_panel.hpp"
+#include "loop_cadence.hpp"
+#include "board_tracker.hpp"
+#include "board_rectifier.hpp"
 
 using namespace cv;
 using namespace std;
 using namespace std::chrono;
 
-// Structure to store space information
-struct Space {
-    Point2f center;
-    double area;
-    int colour;
-    int row;
-    int col;
-    int position_id; // 1-9 for 3x3 grid
-};
+// The robot_headless build starts without windows; --gui brings them back
+#ifndef ROBOT_HEADLESS_DEFAULT
+#define ROBOT_HEADLESS_DEFAULT 0
+#endif
 
 // Global variables
+BoardGeometry boardGeometry; // Rows and columns of the board (--board), 3x3 by default
 vector<Space> savedSpaces;
+vector<int> spaceIndexByPosition; // savedSpaces index for each position_id, -1 where missing
+vector<Point> savedBoardContour;
 bool spacesCalibrated = false;
+const string CALIBRATION_FILE = "board_calibration.bin"; // Reloaded at startup when still valid
 Mat emptyFrame;
 bool emptyFrameCaptured = false;
 bool continuousColourDetection = false;
-VideoCapture global_cap(0); // Global camera object
+FrameGrabber global_grabber; // Owns the camera and captures on its own thread
+RobotCommandQueue robotQueue; // Sends robot commands on its own thread
+MoveVerifier moveVerifier; // Confirms robot moves from the live colour readings
+volatile sig_atomic_t stopRequested = 0; // Set by SIGINT/SIGTERM in headless mode
+
+// Per-stage latency of the main loop, dumped to LATENCY_FILE every few seconds
+StageProfiler profiler;
+const int STAGE_FRAME_AGE = profiler.addStage("frame age");
+const int STAGE_COLOUR_CHECK = profiler.addStage("colour check");
+const int STAGE_OVERLAY = profiler.addStage("overlay");
+const int STAGE_CONTROL_PANEL = profiler.addStage("control panel");
+const int STAGE_IMSHOW = profiler.addStage("imshow");
+const int STAGE_WAITKEY = profiler.addStage("waitKey");
+const int STAGE_LOOP = profiler.addStage("loop total");
+const string LATENCY_FILE = "latency_stats.csv";
+bool showLatencyOverlay = false; // Toggled with 'l' in the live feed
+ColourLUT colourLUT; // BGR -> colour class table compiled from the HSV thresholds at startup
+SpaceColourClassifier spaceClassifier; // Per-space patch classifier built at calibration
+BoardTracker boardTracker; // Follows small bumps of the camera or board between calibrations
+BoardRectifier boardRectifier; // Top-down board view the live colours are sampled from
+MoveCostModel moveCostModel; // Arm timing estimates used to plan resets, refined as moves complete
+BackgroundLayoutPlanner layoutPlanner; // Plans (and caches) layout moves off the main loop
 
 // GUI state variables
 int selectedColour = 0; // 0=None, 1=Red, 2=Blue, 3=Green
-int selectedRow = 0;   // 0=None, 1-3=Row number
+int selectedRow = 0;   // 0=None, otherwise the row number
 
 // Button regions for mouse clicks
 Rect calibrateBtn = Rect(50, 100, 300, 50);
 Rect colourRedBtn = Rect(50, 200, 80, 30);
 Rect colourBlueBtn = Rect(140, 200, 80, 30);
 Rect colourGreenBtn = Rect(230, 200, 80, 30);
-Rect row1Btn = Rect(50, 250, 80, 30);
-Rect row2Btn = Rect(140, 250, 80, 30);
-Rect row3Btn = Rect(230, 250, 80, 30);
+vector<Rect> rowBtns; // One per board row, laid out by createControlPanel
 Rect executeBtn = Rect(50, 300, 300, 50);
 Rect resetBtn = Rect(50, 370, 140, 40);
 Rect homeBtn = Rect(200, 370, 140, 40);
 Rect colourDetectionBtn = Rect(50, 450, 300, 30);
 
-// Colour mapping
-map<int, string> colourNames = {
-    {1, "Red"},
-    {2, "Blue"},
-    {3, "Green"},
-    {0, "None"}
-};
-
-// Position mapping: row and column to position_id
-map<pair<int, int>, int> positionMap = {
-    {{1, 1}, 1}, {{1, 2}, 2}, {{1, 3}, 3},
-    {{2, 1}, 4}, {{2, 2}, 5}, {{2, 3}, 6},
-    {{3, 1}, 7}, {{3, 2}, 8}, {{3, 3}, 9}
-};
-
-// Reset command mapping: (pick_row, place_row) -> cmd
-map<pair<int, int>, unsigned char> resetCmdMap = {
-    {{1, 1}, 129}, // C3R1 -> C1R1
-    {{1, 2}, 130}, // C3R1 -> C1R2
-    {{1, 3}, 131}, // C3R1 -> C1R3
-    {{2, 1}, 133}, // C3R2 -> C1R1
-    {{2, 2}, 134}, // C3R2 -> C1R2
-    {{2, 3}, 135}, // C3R2 -> C1R3
-    {{3, 1}, 137}, // C3R3 -> C1R1
-    {{3, 2}, 138}, // C3R3 -> C1R2
-    {{3, 3}, 139}  // C3R3 -> C1R3
-};
+// Control panel, redrawn per widget as the state behind it changes
+ControlPanel controlPanel(Size(400, 600), Scalar(60, 60, 60));
+int calibrationStatusWidget, robotStatusWidget, executeWidget, selectionWidget, resetWidget, detectionWidget;
+int colourButtonWidgets[3];
+vector<int> rowButtonWidgets;
 
 // Forward declarations
-bool captureEmptyFrame(VideoCapture& cap);
-void executeMove(struct sp_port* port);
-void executeReset(struct sp_port* port);
+bool captureEmptyFrame(FrameGrabber& grabber);
+bool loadSavedCalibration(FrameGrabber& grabber);
+void applyCalibration(Size frameSize);
+void updateSamplingPatches(Size frameSize);
+void executeMove(RobotCommandQueue& queue);
+void executeReset(RobotCommandQueue& queue);
+void executeHome(RobotCommandQueue& queue);
+void executeLayout(const string& layout, RobotCommandQueue& queue);
+bool legacyCodeForMove(const PlannedMove& move, unsigned char& cmd);
+void submitPlan(RobotCommandQueue& queue, const vector<PlannedMove>& moves, const string& label, milliseconds holdPerMove);
+void applyMoves(const vector<PlannedMove>& moves);
+vector<ExpectedSpace> expectedAfter(const vector<PlannedMove>& moves);
 int getPositionId(int row, int col);
+Space* findSpaceByPosition(int position_id);
 Space* findBlockByColour(int colourCode);
-vector<Space*> findBlocksInColumn3();
-vector<Space*> findEmptyPositionsInColumn1();
+vector<Space*> findBlocksInColumn(int col);
+vector<Space*> findEmptyPositionsInColumn(int col);
+GridCell toGridCell(const Space& space);
 void checkSpaceColoursLive(Mat& liveFrame);
-int detectColour(Mat& original, int x, int y);
-vector<Point> detectBoard(Mat& thresholded, Mat& original);
-vector<Space> detectSpacesInBoard(Mat& thresholded, Mat& original, const vector<Point>& boardContour);
+void updateSpaceColours(const Mat& liveFrame);
+void drawSpaceColours(Mat& liveFrame);
+void printLatencyStats();
+void calibrateMatrix();
+void selectColour(int colourCode);
+void selectRow(int row);
+void toggleColourDetection();
+void printBoardState();
+bool handleControlCommand(const string& line, RobotCommandQueue& queue);
+void runHeadless(RobotCommandQueue& queue, double visionHz);
+void verifyActiveCommand();
 
 // Mouse callback for control panel
-void onMouse(int event, int x, int y, int flags, void* userdata) {
+void onMouse(int event, int x, int y, int /*flags*/, void* userdata) {
     if (event == EVENT_LBUTTONDOWN) {
         Point pt(x, y);
-        struct sp_port* port = (struct sp_port*)userdata;
+        RobotCommandQueue& queue = *(RobotCommandQueue*)userdata;
 
         // Check which button was clicked
         if (calibrateBtn.contains(pt)) {
-            cout << "Calibrating matrix..." << endl;
-            if (captureEmptyFrame(global_cap)) {
-                cout << "Calibration successful!" << endl;
-                continuousColourDetection = true;
-                cout << "Continuous colour detection started automatically" << endl;
-            }
-            else {
-                cout << "Calibration failed. Adjust camera/view and try again." << endl;
-            }
+            calibrateMatrix();
         }
         else if (colourRedBtn.contains(pt)) {
-            selectedColour = 1;
-            cout << "Selected: Red" << endl;
+            selectColour(1);
         }
         else if (colourBlueBtn.contains(pt)) {
-            selectedColour = 2;
-            cout << "Selected: Blue" << endl;
+            selectColour(2);
         }
         else if (colourGreenBtn.contains(pt)) {
-            selectedColour = 3;
-            cout << "Selected: Green" << endl;
-        }
-        else if (row1Btn.contains(pt)) {
-            selectedRow = 1;
-            cout << "Selected: Row 1" << endl;
-        }
-        else if (row2Btn.contains(pt)) {
-            selectedRow = 2;
-            cout << "Selected: Row 2" << endl;
-        }
-        else if (row3Btn.contains(pt)) {
-            selectedRow = 3;
-            cout << "Selected: Row 3" << endl;
+            selectColour(3);
         }
         else if (executeBtn.contains(pt)) {
             cout << "Executing move..." << endl;
-            executeMove(port);
+            executeMove(queue);
         }
         else if (resetBtn.contains(pt)) {
             cout << "Executing reset..." << endl;
-            executeReset(port);
+            executeReset(queue);
         }
         else if (homeBtn.contains(pt)) {
             cout << "Going home..." << endl;
-            if (port) {
-                unsigned char cmd = 64;
-                sp_blocking_write(port, &cmd, 1, 100);
-                this_thread::sleep_for(milliseconds(2000));
-                cmd = 0;
-                sp_blocking_write(port, &cmd, 1, 100);
-                cout << "Home position set!" << endl;
-            }
+            executeHome(queue);
         }
         else if (colourDetectionBtn.contains(pt)) {
-            if (spacesCalibrated) {
-                continuousColourDetection = !continuousColourDetection;
-                cout << "Continuous colour detection: " << (continuousColourDetection ? "ON" : "OFF") << endl;
-            }
-            else {
-                cout << "Please calibrate matrix first!" << endl;
+            toggleColourDetection();
+        }
+        else {
+            for (size_t i = 0; i < rowBtns.size(); i++) {
+                if (rowBtns[i].contains(pt)) {
+                    selectRow((int)i + 1);
+                    break;
+                }
             }
         }
     }
 }
 
-// Function to create control panel GUI
-void createControlPanel() {
-    Mat controlPanel = Mat::zeros(600, 400, CV_8UC3);
+// Function to calibrate the matrix from the empty board
+void calibrateMatrix() {
+    cout << "Calibrating matrix..." << endl;
+    if (captureEmptyFrame(global_grabber)) {
+        cout << "Calibration successful!" << endl;
+        continuousColourDetection = true;
+        cout << "Continuous colour detection started automatically" << endl;
+    }
+    else {
+        cout << "Calibration failed. Adjust camera/view and try again." << endl;
+    }
+}
 
-    // Set background colour
-    controlPanel.setTo(Scalar(60, 60, 60));
+// Function to select the colour of the block to move
+void selectColour(int colourCode) {
+    selectedColour = colourCode;
+    cout << "Selected: " << colourName(colourCode) << endl;
+}
 
-    // Title
-    putText(controlPanel, "Robot Control Panel", Point(20, 30),
-        FONT_HERSHEY_SIMPLEX, 0.7, Scalar(255, 255, 255), 2);
+// Function to select the target row in the last column
+void selectRow(int row) {
+    selectedRow = row;
+    cout << "Selected: Row " << row << endl;
+}
 
-    // Calibration section
-    rectangle(controlPanel, calibrateBtn, Scalar(100, 100, 100), -1);
-    rectangle(controlPanel, calibrateBtn, Scalar(200, 200, 200), 2);
-    putText(controlPanel, "Calibrate Matrix", Point(60, 130),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+// Function to switch continuous colour detection on or off
+void toggleColourDetection() {
+    if (spacesCalibrated) {
+        continuousColourDetection = !continuousColourDetection;
+        cout << "Continuous colour detection: " << (continuousColourDetection ? "ON" : "OFF") << endl;
+    }
+    else {
+        cout << "Please calibrate matrix first!" << endl;
+    }
+}
 
-    // Status
-    string statusText = spacesCalibrated ? "CALIBRATED" : "NOT CALIBRATED";
-    Scalar statusColour = spacesCalibrated ? Scalar(0, 255, 0) : Scalar(0, 0, 255);
-    putText(controlPanel, statusText, Point(20, 80),
-        FONT_HERSHEY_SIMPLEX, 0.5, statusColour, 1);
+// Function to print the calibration, robot and board state
+void printBoardState() {
+    cout << "Calibrated: " << (spacesCalibrated ? "yes" : "no")
+        << ", colour detection: " << (continuousColourDetection ? "on" : "off")
+        << ", robot commands pending: " << robotQueue.pending()
+        << ", board drift corrections: " << boardTracker.corrections << endl;
+    cout << "Selection: " << colourName(selectedColour) << " -> Row " << selectedRow << endl;
+    for (const Space& space : savedSpaces) {
+        cout << "R" << space.row << "C" << space.col << ":" << colourName(space.colour) << " ";
+    }
+    if (!savedSpaces.empty()) {
+        cout << endl;
+    }
+}
 
-    // Colour selection
-    putText(controlPanel, "Select Colour:", Point(20, 180),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+// Function to run one line from the headless control channel; returns false on quit
+bool handleControlCommand(const string& line, RobotCommandQueue& queue) {
+    istringstream words(line);
+    string command, argument;
+    words >> command >> argument;
 
-    // Colour buttons
-    rectangle(controlPanel, colourRedBtn, selectedColour == 1 ? Scalar(0, 0, 255) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourRedBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Red", Point(65, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    if (command.empty()) {
+        return true;
+    }
+    else if (command == "calibrate") {
+        calibrateMatrix();
+    }
+    else if (command == "colour" || command == "color") {
+        if (argument == "red") selectColour(1);
+        else if (argument == "blue") selectColour(2);
+        else if (argument == "green") selectColour(3);
+        else cout << "Unknown colour: " << argument << " (use red, blue or green)" << endl;
+    }
+    else if (command == "row") {
+        int row = atoi(argument.c_str());
+        if (row >= 1 && row <= boardGeometry.rows) selectRow(row);
+        else cout << "Invalid row: " << argument << " (use 1-" << boardGeometry.rows << ")" << endl;
+    }
+    else if (command == "execute") {
+        cout << "Executing move..." << endl;
+        executeMove(queue);
+    }
+    else if (command == "reset") {
+        cout << "Executing reset..." << endl;
+        executeReset(queue);
+    }
+    else if (command == "home") {
+        cout << "Going home..." << endl;
+        executeHome(queue);
+    }
+    else if (command == "layout") {
+        executeLayout(argument, queue);
+    }
+    else if (command == "detect") {
+        if ((argument == "on") != continuousColourDetection || argument.empty()) {
+            toggleColourDetection();
+        }
+    }
+    else if (command == "status") {
+        printBoardState();
+    }
+    else if (command == "stats") {
+        printLatencyStats();
+    }
+    else if (command == "quit" || command == "exit") {
+        return false;
+    }
+    else {
+        cout << "Commands: calibrate | colour <red|blue|green> | row <1-" << boardGeometry.rows << "> | execute"
+            << " | reset | home | layout <" << boardGeometry.spaces() << " of R/B/G/./*> | detect [on|off]"
+            << " | status | stats | quit" << endl;
+    }
+    return true;
+}
 
-    rectangle(controlPanel, colourBlueBtn, selectedColour == 2 ? Scalar(255, 0, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourBlueBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Blue", Point(155, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+// Handles SIGINT/SIGTERM so the headless loop can shut the robot down cleanly
+void onStopSignal(int) {
+    stopRequested = 1;
+}
 
-    rectangle(controlPanel, colourGreenBtn, selectedColour == 3 ? Scalar(0, 255, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourGreenBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Green", Point(245, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-    
-    // Row selection
-    putText(controlPanel, "Select Target Location:", Point(20, 240),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+// Main loop without any HighGUI windows: commands arrive on stdin instead of mouse clicks
+void runHeadless(RobotCommandQueue& queue, double visionHz) {
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+
+    ControlChannel control;
+    control.start();
+    cout << "Headless mode: type commands on stdin ('help' for a list)" << endl;
+    Cadence visionCadence(visionHz);
+    bool inputClosed = false;
+
+    while (!stopRequested) {
+        // Apply the results of any robot commands and layout searches that finished since the last frame
+        queue.dispatchCompletions();
+        layoutPlanner.dispatchCompletions();
+
+        // Without the camera watching, moves waiting for confirmation end on the robot's ack
+        queue.setConfirmationAvailable(spacesCalibrated && continuousColourDetection);
+
+        string line;
+        bool quit = false;
+        while (!quit && control.poll(line)) {
+            quit = !handleControlCommand(line, queue);
+        }
+        if (quit) {
+            cout << "Quitting..." << endl;
+            break;
+        }
 
-    rectangle(controlPanel, row1Btn, selectedRow == 1 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row1Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,1", Point(65, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+        // Once the input has ended (a piped script ran out or the terminal went away) no more
+        // commands can arrive: finish what is queued or still being planned, then quit
+        if (control.closed()) {
+            if (!inputClosed) {
+                cout << "Input closed; quitting once the robot is idle" << endl;
+                inputClosed = true;
+            }
+            if (!queue.busy() && !layoutPlanner.busy()) {
+                cout << "Quitting..." << endl;
+                break;
+            }
+        }
 
-    rectangle(controlPanel, row2Btn, selectedRow == 2 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row2Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,2", Point(155, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+        // Same vision pipeline as the GUI, without any drawing
+        Mat liveFrame;
+        StageProfiler::Clock::time_point capturedAt;
+        StageProfiler::Clock::time_point now = StageProfiler::Clock::now();
+        if (visionCadence.ready(now) && global_grabber.acquireLatest(liveFrame, &capturedAt)) {
+            visionCadence.consume(now);
+            profiler.record(STAGE_FRAME_AGE, capturedAt, StageProfiler::Clock::now());
+            if (spacesCalibrated && continuousColourDetection) {
+                StageProfiler::Scope timer(profiler, STAGE_COLOUR_CHECK);
+                updateSpaceColours(liveFrame);
+                verifyActiveCommand();
+            }
+        }
+        else {
+            this_thread::sleep_for(milliseconds(2));
+        }
 
-    rectangle(controlPanel, row3Btn, selectedRow == 3 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row3Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,3", Point(245, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+        profiler.dumpIfDue(LATENCY_FILE, seconds(5));
+    }
+}
 
-    // Execute button
-    bool canExecute = (selectedColour > 0 && selectedRow > 0 && spacesCalibrated);
-    rectangle(controlPanel, executeBtn, canExecute ? Scalar(0, 100, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, executeBtn, Scalar(200, 200, 200), 2);
-    putText(controlPanel, "EXECUTE MOVE", Point(80, 330),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+// Function to draw a button with a fill, a border and a label
+void drawButton(Mat& panel, const Rect& area, const Scalar& fill, int border, const string& label, Point labelAt, double scale) {
+    rectangle(panel, area, fill, -1);
+    rectangle(panel, area, Scalar(200, 200, 200), border);
+    putText(panel, label, labelAt, FONT_HERSHEY_SIMPLEX, scale, Scalar(255, 255, 255), 1);
+}
 
-    // Current selection display
-    string selectionText = "Current: " + colourNames[selectedColour] + " -> Row " + to_string(selectedRow);
-    putText(controlPanel, selectionText, Point(20, 360),
-        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 0), 1);
+// Function to create control panel GUI: static content goes into the background once and
+// everything that depends on state becomes a widget that is only redrawn when it changes
+void createControlPanel() {
+    Mat& background = controlPanel.background();
 
-    // Special commands
-    rectangle(controlPanel, resetBtn, spacesCalibrated ? Scalar(0, 0, 100) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, resetBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "RESET", Point(70, 395), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    // Title
+    putText(background, "Robot Control Panel", Point(20, 30),
+        FONT_HERSHEY_SIMPLEX, 0.7, Scalar(255, 255, 255), 2);
 
-    rectangle(controlPanel, homeBtn, Scalar(100, 0, 0), -1);
-    rectangle(controlPanel, homeBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "HOME", Point(230, 395), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    // Calibration section
+    drawButton(background, calibrateBtn, Scalar(100, 100, 100), 2, "Calibrate Matrix", Point(60, 130), 0.5);
 
-    // Colour detection toggle
-    rectangle(controlPanel, colourDetectionBtn, continuousColourDetection ? Scalar(0, 100, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourDetectionBtn, Scalar(200, 200, 200), 1);
-    string detectionText = continuousColourDetection ? "Colour Detection: ON" : "Colour Detection: OFF";
-    putText(controlPanel, detectionText, Point(60, 470),
-        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
+    // Colour and row selection labels
+    putText(background, "Select Colour:", Point(20, 180),
+        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+    putText(background, "Select Target Location:", Point(20, 240),
+        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
+
+    drawButton(background, homeBtn, Scalar(100, 0, 0), 1, "HOME", Point(230, 395), 0.4);
 
     // Instructions
-    putText(controlPanel, "Instructions:", Point(20, 520),
+    putText(background, "Instructions:", Point(20, 520),
         FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-    putText(controlPanel, "ENSURE MATRIX IS EMPTY WHEN CALIBRATING!", Point(20, 540),
+    putText(background, "ENSURE MATRIX IS EMPTY WHEN CALIBRATING!", Point(20, 540),
         FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Greyed out buttons = disabled", Point(20, 560),
+    putText(background, "Greyed out buttons = disabled", Point(20, 560),
         FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Press 'q' in any window to quit", Point(20, 580),
+    putText(background, "Press 'q' in any window to quit", Point(20, 580),
         FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
 
-    imshow("Control Panel", controlPanel);
-}
+    // Status
+    calibrationStatusWidget = controlPanel.addWidget(Rect(0, 64, 195, 22), [](Mat& panel) {
+        putText(panel, spacesCalibrated ? "CALIBRATED" : "NOT CALIBRATED", Point(20, 80),
+            FONT_HERSHEY_SIMPLEX, 0.5, spacesCalibrated ? Scalar(0, 255, 0) : Scalar(0, 0, 255), 1);
+        });
+
+    // Robot status
+    robotStatusWidget = controlPanel.addWidget(Rect(195, 64, 205, 22), [](Mat& panel) {
+        size_t queued = robotQueue.pending();
+        string robotText = queued > 0 ? "ROBOT BUSY (" + to_string(queued) + " queued)" : "ROBOT IDLE";
+        putText(panel, robotText, Point(200, 80),
+            FONT_HERSHEY_SIMPLEX, 0.5, queued > 0 ? Scalar(0, 165, 255) : Scalar(0, 255, 0), 1);
+        });
 
-// Function to detect colour at specific coordinates and return integer code
-int detectColour(Mat& original, int x, int y) {
-    if (x < 0 || x >= original.cols || y < 0 || y >= original.rows) {
-        return 0;
+    // Colour buttons
+    static const struct { const Rect* area; int colour; Scalar fill; const char* label; Point labelAt; } colourButtons[] = {
+        { &colourRedBtn, 1, Scalar(0, 0, 255), "Red", Point(65, 220) },
+        { &colourBlueBtn, 2, Scalar(255, 0, 0), "Blue", Point(155, 220) },
+        { &colourGreenBtn, 3, Scalar(0, 255, 0), "Green", Point(245, 220) }
+    };
+    for (int i = 0; i < 3; i++) {
+        colourButtonWidgets[i] = controlPanel.addWidget(*colourButtons[i].area, [i](Mat& panel) {
+            const auto& button = colourButtons[i];
+            drawButton(panel, *button.area, selectedColour == button.colour ? button.fill : Scalar(50, 50, 50), 1,
+                button.label, button.labelAt, 0.4);
+            });
     }
 
-    Mat hsv;
-    cvtColour(original, hsv, COLOR_BGR2HSV);
-
-    Vec3b pixel = hsv.at<Vec3b>(y, x);
-    int hue = pixel[0];
-    int saturation = pixel[1];
-    int value = pixel[2];
-
-    if ((hue >= 140 && hue <= 180) && saturation > 100 && value > 50) {
-        return 1; // Red
-    }
-    else if (hue >= 100 && hue <= 135 && saturation > 100 && value > 50) {
-        return 2; // Blue
-    }
-    else if (hue >= 30 && hue <= 80 && saturation > 100 && value > 50) {
-        return 3; // Green
+    // Row buttons, one per board row, shared out across the same 300 pixel strip
+    int rowSlot = max(1, 300 / boardGeometry.rows);
+    int rowGap = min(10, rowSlot / 4);
+    int rowWidth = max(1, min(80, rowSlot - rowGap));
+    rowBtns.clear();
+    rowButtonWidgets.clear();
+    for (int i = 0; i < boardGeometry.rows; i++) {
+        rowBtns.push_back(Rect(50 + i * (rowWidth + rowGap), 250, rowWidth, 30));
+        rowButtonWidgets.push_back(controlPanel.addWidget(rowBtns[i], [i, rowWidth](Mat& panel) {
+            const Rect& area = rowBtns[i];
+            string label = rowWidth >= 50 ? to_string(boardGeometry.cols) + "," + to_string(i + 1) : to_string(i + 1);
+            drawButton(panel, area, selectedRow == i + 1 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), 1,
+                label, Point(area.x + min(15, rowWidth / 4), 270), rowWidth >= 30 ? 0.4 : 0.3);
+            }));
     }
 
-    return 0;
-}
+    // Execute button
+    executeWidget = controlPanel.addWidget(executeBtn, [](Mat& panel) {
+        bool canExecute = (selectedColour > 0 && selectedRow > 0 && spacesCalibrated);
+        drawButton(panel, executeBtn, canExecute ? Scalar(0, 100, 0) : Scalar(50, 50, 50), 2,
+            "EXECUTE MOVE", Point(80, 330), 0.5);
+        });
 
-// Function to detect the largest dark object (board)
-vector<Point> detectBoard(Mat& thresholded, Mat& original) {
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
+    // Current selection display
+    selectionWidget = controlPanel.addWidget(Rect(0, 351, 400, 17), [](Mat& panel) {
+        string selectionText = string("Current: ") + colourName(selectedColour) + " -> Row " + to_string(selectedRow);
+        putText(panel, selectionText, Point(20, 360),
+            FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 0), 1);
+        });
 
-    findContours(thresholded, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+    // Special commands
+    resetWidget = controlPanel.addWidget(resetBtn, [](Mat& panel) {
+        drawButton(panel, resetBtn, spacesCalibrated ? Scalar(0, 0, 100) : Scalar(50, 50, 50), 1,
+            "RESET", Point(70, 395), 0.4);
+        });
 
-    double maxArea = 0;
-    int maxAreaIdx = -1;
+    // Colour detection toggle
+    detectionWidget = controlPanel.addWidget(colourDetectionBtn, [](Mat& panel) {
+        drawButton(panel, colourDetectionBtn, continuousColourDetection ? Scalar(0, 100, 0) : Scalar(50, 50, 50), 1,
+            continuousColourDetection ? "Colour Detection: ON" : "Colour Detection: OFF", Point(60, 470), 0.4);
+        });
+}
 
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area > maxArea) {
-            maxArea = area;
-            maxAreaIdx = i;
-        }
+// Function to refresh the control panel; only widgets whose state changed are redrawn and the
+// window is only updated when something did
+void updateControlPanel() {
+    controlPanel.setState(calibrationStatusWidget, spacesCalibrated);
+    controlPanel.setState(robotStatusWidget, (long long)robotQueue.pending());
+    for (int i = 0; i < 3; i++) {
+        controlPanel.setState(colourButtonWidgets[i], selectedColour == i + 1);
     }
-
-    if (maxAreaIdx >= 0 && maxArea > 10000) {
-        drawContours(original, contours, maxAreaIdx, Scalar(0, 255, 255), 3);
-        return contours[maxAreaIdx];
+    for (size_t i = 0; i < rowButtonWidgets.size(); i++) {
+        controlPanel.setState(rowButtonWidgets[i], selectedRow == (int)i + 1);
     }
+    controlPanel.setState(executeWidget, selectedColour > 0 && selectedRow > 0 && spacesCalibrated);
+    controlPanel.setState(selectionWidget, selectedColour * 256 + selectedRow);
+    controlPanel.setState(resetWidget, spacesCalibrated);
+    controlPanel.setState(detectionWidget, continuousColourDetection);
 
-    return vector<Point>();
+    if (controlPanel.render()) {
+        imshow("Control Panel", controlPanel.image());
+    }
 }
 
-// Function to detect spaces within the board region
-vector<Space> detectSpacesInBoard(Mat& thresholded, Mat& original, const vector<Point>& boardContour) {
-    vector<Space> spaces;
-
-    if (boardContour.empty()) return spaces;
-
-    Mat boardMask = Mat::zeros(thresholded.size(), CV_8UC1);
-    vector<vector<Point>> boardContours = { boardContour };
-    fillPoly(boardMask, boardContours, Scalar(255));
-
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
+// Function to prepare live colour tracking for the current savedSpaces
+void applyCalibration(Size frameSize) {
+    spacesCalibrated = true;
+    spaceIndexByPosition.assign(boardGeometry.spaces() + 1, -1);
+    for (size_t i = 0; i < savedSpaces.size(); i++) {
+        int id = savedSpaces[i].position_id;
+        if (id >= 1 && id <= boardGeometry.spaces()) spaceIndexByPosition[id] = (int)i;
+    }
+    if (!boardRectifier.calibrate(savedBoardContour)) {
+        cout << "Warning: Board outline has no clear corners, sampling the raw frame" << endl;
+    }
+    updateSamplingPatches(frameSize);
 
-    Mat spacesImage;
-    bitwise_not(thresholded, spacesImage);
-    bitwise_and(spacesImage, boardMask, spacesImage);
+    if (!boardTracker.reset(savedBoardContour, savedSpaces)) {
+        cout << "Warning: Board outline has no clear corners, drift tracking is off" << endl;
+    }
+}
 
-    findContours(spacesImage, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+// Function to precompute the colour sampling patches for the current space centres, in the
+// top-down board view when there is one
+void updateSamplingPatches(Size frameSize) {
+    vector<Point2f> centres;
+    for (size_t i = 0; i < savedSpaces.size(); i++) {
+        centres.push_back(boardRectifier.ready() ? boardRectifier.project(savedSpaces[i].center) : savedSpaces[i].center);
+    }
+    spaceClassifier.calibrate(centres, boardRectifier.ready() ? boardRectifier.boardSize() : frameSize);
+}
 
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area < 100 || area > 10000) continue;
+// Function to reuse the calibration saved by a previous run if the board has not moved
+bool loadSavedCalibration(FrameGrabber& grabber) {
+    BoardCalibration calibration;
+    if (!loadCalibration(CALIBRATION_FILE, calibration)) {
+        return false;
+    }
+    if (!calibrationFitsBoard(calibration, boardGeometry)) {
+        cout << "Saved calibration is for a different board size. Please calibrate." << endl;
+        return false;
+    }
 
-        Point2f center;
-        float radius;
-        minEnclosingCircle(contours[i], center, radius);
+    Mat frame;
+    if (!grabber.waitForFrame(frame, 2000)) {
+        cout << "Cannot read frame from camera to check saved calibration" << endl;
+        return false;
+    }
 
-        if (pointPolygonTest(boardContour, center, false) >= 0) {
-            double perimeter = arcLength(contours[i], true);
-            double circularity = 0;
-            if (perimeter > 0) {
-                circularity = (4 * CV_PI * area) / (perimeter * perimeter);
-            }
+    // The board outline is still visible with blocks on it, so this works on a full board
+    Mat imgThresholded;
+    thresholdBoard(frame, colourLUT, imgThresholded);
+    Mat scratch = frame.clone();
+    vector<Point> liveContour = detectBoard(imgThresholded, scratch);
 
-            if (circularity > 0.5) {
-                Space space;
-                space.center = center;
-                space.area = area;
-                space.colour = 0;
-                spaces.push_back(space);
-            }
-        }
+    if (!calibrationMatchesBoard(calibration, frame.size(), liveContour)) {
+        cout << "Saved calibration does not match the current view. Please calibrate." << endl;
+        return false;
     }
 
-    return spaces;
+    savedSpaces = calibration.spaces;
+    savedBoardContour = calibration.boardContour;
+    applyCalibration(calibration.frameSize);
+    cout << "Loaded saved calibration with " << savedSpaces.size() << " spaces" << endl;
+    return true;
 }
 
 // Function to capture and process empty frame
-bool captureEmptyFrame(VideoCapture& cap) {
+bool captureEmptyFrame(FrameGrabber& grabber) {
+    // Wait for a fresh frame so no live feed overlays end up in the calibration image
     Mat frame;
-    if (!cap.read(frame)) {
+    if (!grabber.waitForFrame(frame, 1000)) {
         cout << "Cannot read frame from camera" << endl;
         return false;
     }
@@ -374,34 +551,21 @@ bool captureEmptyFrame(VideoCapture& cap) {
 
     cout << "Empty frame captured! Processing spaces..." << endl;
 
-    Mat imgHSV;
-    cvtColour(emptyFrame, imgHSV, COLOR_BGR2HSV);
-
-    Mat imgThresholded;
-    inRange(imgHSV, Scalar(0, 0, 0), Scalar(179, 255, 100), imgThresholded);
-
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
-    morphologyEx(imgThresholded, imgThresholded, MORPH_CLOSE, kernel);
-    morphologyEx(imgThresholded, imgThresholded, MORPH_OPEN, kernel);
-
-    vector<Point> boardContour = detectBoard(imgThresholded, emptyFrame);
-    savedSpaces = detectSpacesInBoard(imgThresholded, emptyFrame, boardContour);
-
-    if (!savedSpaces.empty()) {
-        spacesCalibrated = true;
+    BoardCalibration calibration;
+    if (calibrateFromFrame(emptyFrame, colourLUT, calibration, boardGeometry)) {
+        savedSpaces = calibration.spaces;
         cout << "Successfully detected " << savedSpaces.size() << " spaces!" << endl;
+        if (calibration.inferred > 0 || calibration.outliers > 0) {
+            cout << "Grid fit: " << calibration.inferred << " missing spaces filled in, "
+                << calibration.outliers << " stray detections ignored" << endl;
+        }
 
-        // Sort spaces by position (left to right, top to bottom)
-        sort(savedSpaces.begin(), savedSpaces.end(), [](const Space& a, const Space& b) {
-            if (a.center.y == b.center.y) return a.center.x < b.center.x;
-            return a.center.y < b.center.y;
-            });
+        savedBoardContour = calibration.boardContour;
+        applyCalibration(emptyFrame.size());
 
-        // Assign grid positions (1-9 for 3x3 grid)
-        for (size_t i = 0; i < savedSpaces.size(); i++) {
-            savedSpaces[i].row = (i / 3) + 1;
-            savedSpaces[i].col = 3 - (i % 3);
-            savedSpaces[i].position_id = positionMap[{savedSpaces[i].row, savedSpaces[i].col}];
+        // Save for the next start so calibration can be skipped while the board stays put
+        if (!saveCalibration(CALIBRATION_FILE, calibration)) {
+            cout << "Warning: Could not save calibration to " << CALIBRATION_FILE << endl;
         }
 
         for (size_t i = 0; i < savedSpaces.size(); i++) {
@@ -416,18 +580,59 @@ bool captureEmptyFrame(VideoCapture& cap) {
         return true;
     }
     else {
-        cout << "No spaces detected in empty frame!" << endl;
+        savedSpaces.clear();
+        cout << "No spaces grid detected in empty frame!" << endl;
         return false;
     }
 }
 
+// Function to update the colour of every saved space from the live feed
+void updateSpaceColours(const Mat& liveFrame) {
+    if (!spacesCalibrated || savedSpaces.empty()) return;
+
+    // Follow small bumps of the board with blocks on it; skipped while the arm may be in view
+    // The board moves as a whole, so with a top-down view only the warp has to follow it
+    if (!robotQueue.busy() && boardTracker.update(liveFrame, colourLUT, savedSpaces)) {
+        if (!boardRectifier.ready()) {
+            updateSamplingPatches(liveFrame.size());
+        }
+        else if (!boardRectifier.calibrate(boardTracker.correctedContour(savedBoardContour))) {
+            // The patches were laid out for the top-down view; move them back onto the raw frame
+            cout << "Warning: Corrected board outline has no clear corners, sampling the raw frame" << endl;
+            updateSamplingPatches(liveFrame.size());
+        }
+    }
+
+    // Classify all spaces from their precomputed patches in one pass, on the small top-down
+    // board image rather than the full camera frame when it is available
+    static vector<SpaceReading> readings;
+    static Mat rectifiedBoard;
+    if (boardRectifier.ready()) {
+        boardRectifier.rectify(liveFrame, rectifiedBoard);
+        spaceClassifier.classify(rectifiedBoard, colourLUT, readings);
+    }
+    else {
+        spaceClassifier.classify(liveFrame, colourLUT, readings);
+    }
+
+    for (size_t i = 0; i < savedSpaces.size(); i++) {
+        savedSpaces[i].colour = readings[i].colour;
+        savedSpaces[i].confidence = readings[i].confidence;
+    }
+}
+
 // Function to check colours at saved space positions on live feed
 void checkSpaceColoursLive(Mat& liveFrame) {
+    updateSpaceColours(liveFrame);
+    drawSpaceColours(liveFrame);
+}
+
+// Function to draw the latest colour of every saved space onto the live feed
+void drawSpaceColours(Mat& liveFrame) {
     if (!spacesCalibrated || savedSpaces.empty()) return;
 
     for (size_t i = 0; i < savedSpaces.size(); i++) {
-        int colourResult = detectColour(liveFrame, savedSpaces[i].center.x, savedSpaces[i].center.y);
-        savedSpaces[i].colour = colourResult;
+        int colourResult = savedSpaces[i].colour;
 
         Scalar colour;
         string colourText;
@@ -435,6 +640,7 @@ void checkSpaceColoursLive(Mat& liveFrame) {
         case 1: colour = Scalar(0, 0, 255); colourText = "R"; break;
         case 2: colour = Scalar(255, 0, 0); colourText = "B"; break;
         case 3: colour = Scalar(0, 255, 0); colourText = "G"; break;
+        case -1: colour = Scalar(0, 255, 255); colourText = "?"; break;
         default: colour = Scalar(128, 128, 128); colourText = "N"; break;
         }
 
@@ -445,25 +651,59 @@ void checkSpaceColoursLive(Mat& liveFrame) {
         putText(liveFrame, label, Point(savedSpaces[i].center.x - 10, savedSpaces[i].center.y + 5),
             FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
     }
+}
 
-    static int frameCount = 0;
-    //if (frameCount++ % 60 == 0) {
-    //    cout << "Current colours: ";
-    //    for (size_t i = 0; i < savedSpaces.size(); i++) {
-    //        cout << "R" << savedSpaces[i].row << "C" << savedSpaces[i].col
-    //            << ":" << colourNames[savedSpaces[i].colour] << " ";
-    //    }
-    //    cout << endl;
-    //}
+// Function to print the rolling latency figures for every stage
+void printLatencyStats() {
+    cout << "stage           min   mean    p95    p99" << endl;
+    for (int i = 0; i < (int)profiler.stageCount(); i++) {
+        cout << profiler.describe(i) << endl;
+    }
+}
+
+// Function to confirm the running robot command from the live colour readings
+void verifyActiveCommand() {
+    RobotCommand active;
+    bool acknowledged = false;
+    if (!robotQueue.activeCommand(active, acknowledged) || active.expected.empty()) {
+        moveVerifier.reset();
+        return;
+    }
+
+    if (moveVerifier.activeCommand() != active.id) {
+        moveVerifier.begin(active.id, active.expected, active.hold);
+    }
+
+    VerifyState state = moveVerifier.update(savedSpaces, acknowledged);
+    if (state == VERIFY_CONFIRMED) {
+        CommandResult result = { true, "confirmed by camera" };
+        result.confirmed = true;
+        robotQueue.completeActive(active.id, result);
+    }
+    else if (state == VERIFY_MISMATCH) {
+        string report = "Board mismatch:";
+        for (const SpaceMismatch& wrong : moveVerifier.mismatchReport()) {
+            Space* space = findSpaceByPosition(wrong.position_id);
+            if (space) {
+                report += " R" + to_string(space->row) + "C" + to_string(space->col);
+            }
+            report += string(" expected ") + colourName(wrong.expected) + " saw " + colourName(wrong.observed) + ";";
+        }
+        robotQueue.completeActive(active.id, CommandResult{ false, report });
+    }
 }
 
 // Function to get position_id from row and column
 int getPositionId(int row, int col) {
-    auto it = positionMap.find({ row, col });
-    if (it != positionMap.end()) {
-        return it->second;
-    }
-    return -1; // Invalid position
+    return boardGeometry.positionId(row, col); // -1 for an invalid position
+}
+
+// Function to find the space with a given position_id
+Space* findSpaceByPosition(int position_id) {
+    if (position_id < 0 || position_id >= (int)spaceIndexByPosition.size()) return nullptr;
+    int index = spaceIndexByPosition[position_id];
+    if (index < 0 || index >= (int)savedSpaces.size() || savedSpaces[index].position_id != position_id) return nullptr;
+    return &savedSpaces[index];
 }
 
 // Function to find a block of specified colour in column 1
@@ -476,30 +716,39 @@ Space* findBlockByColour(int colourCode) {
     return nullptr;
 }
 
-// Function to find blocks in column 3 (for reset operation)
-vector<Space*> findBlocksInColumn3() {
+// Function to find blocks in a column (the last one, for the reset operation)
+vector<Space*> findBlocksInColumn(int col) {
     vector<Space*> blocks;
     for (auto& space : savedSpaces) {
-        if (space.col == 3 && space.colour != 0) {
+        if (space.col == col && space.colour > 0) {
             blocks.push_back(&space);
         }
     }
     return blocks;
 }
 
-// Function to find empty positions in column 1 (for reset operation)
-vector<Space*> findEmptyPositionsInColumn1() {
+// Function to find empty positions in a column (column 1, for the reset operation)
+vector<Space*> findEmptyPositionsInColumn(int col) {
     vector<Space*> emptyPositions;
     for (auto& space : savedSpaces) {
-        if (space.col == 1 && space.colour == 0) {
+        if (space.col == col && space.colour == 0) {
             emptyPositions.push_back(&space);
         }
     }
     return emptyPositions;
 }
 
+// Function to describe a space to the move planner
+GridCell toGridCell(const Space& space) {
+    return GridCell{ space.position_id, space.row, space.col };
+}
+
 // Function to execute movement based on GUI selection
-void executeMove(struct sp_port* port) {
+void executeMove(RobotCommandQueue& queue) {
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
+    }
     if (selectedColour == 0 || selectedRow == 0) {
         cout << "Please select both colour and row first!" << endl;
         return;
@@ -509,40 +758,42 @@ void executeMove(struct sp_port* port) {
         return;
     }
 
-    string colourName = colourNames[selectedColour];
-    cout << "Executing move: " << colourName << " block to row " << selectedRow << " column 3" << endl;
+    string blockName = colourName(selectedColour);
+    int placeCol = boardGeometry.cols;
+    cout << "Executing move: " << blockName << " block to row " << selectedRow << " column " << placeCol << endl;
 
     // Find the block to pick (in column 1)
     Space* pick_space = findBlockByColour(selectedColour);
     if (!pick_space) {
-        cout << "No " << colourName << " block found in column 1!" << endl;
+        cout << "No " << blockName << " block found in column 1!" << endl;
         return;
     }
     
-    // Find the place position (target row, column 3)
-    int place_position = getPositionId(selectedRow, 3);
+    // Find the place position (target row, last column)
+    int place_position = getPositionId(selectedRow, placeCol);
     if (place_position == -1) {
-        cout << "Error: Could not find position for row " << selectedRow << " column 3." << endl;
+        cout << "Error: Could not find position for row " << selectedRow << " column " << placeCol << "." << endl;
         return;
     }
     // Find the place space
-    Space* place_space = nullptr;
-    for (auto& space : savedSpaces) {
-        if (space.position_id == place_position) {
-            place_space = &space;
-            break;
-        }
-    }
+    Space* place_space = findSpaceByPosition(place_position);
 
     if (!place_space) {
         cout << "Error: Could not find space for the specified place position." << endl;
         return;
     }
 
+    // Refuse to place onto a space whose reading cannot be trusted
+    if (place_space->colour == -1) {
+        cout << "Place position R" << place_space->row << "C" << place_space->col
+            << " reading is uncertain! Check the board and try again." << endl;
+        return;
+    }
+
     // Check if place position is empty
     if (place_space->colour != 0) {
         cout << "Place position R" << place_space->row << "C" << place_space->col
-            << " is not empty! It contains " << colourNames[place_space->colour] << " block." << endl;
+            << " is not empty! It contains " << colourName(place_space->colour) << " block." << endl;
         return;
     }
 
@@ -550,58 +801,36 @@ void executeMove(struct sp_port* port) {
         << " (Position " << pick_space->position_id << ")" << endl;
     cout << "Place to: R" << place_space->row << "C" << place_space->col
         << " (Position " << place_space->position_id << ")" << endl;
-    cout << "Block colour: " << colourName << endl;
-
-    int pick = pick_space->row;  // Use row number (1-3)
-    int place = place_space->row; // Use row number (1-3)
-    // Use some binary calculation to calculate the value to send
-    unsigned char cmd = (unsigned char)((((pick - 1) << 4) | (place - 1)) + 1);
-
-    cout << "Generated command: pick_row=" << pick << ", place_row=" << place << ", cmd=" << int(cmd) << endl;
-
-    // Send command sequence
-    if (port) {
-        sp_blocking_write(port, &cmd, 1, 100);
-        cout << "Command sent: " << int(cmd) << endl;
-
-        // Wait 2 seconds
-        this_thread::sleep_for(milliseconds(2000));
-
-        // Send zero command
-        cmd = 0;
-        sp_blocking_write(port, &cmd, 1, 100);
-        sp_drain(port);
+    cout << "Block colour: " << blockName << endl;
 
-        cout << "Command reset" << endl;
-    }
-    else {
-        cout << "Serial port not available!" << endl;
-    }
-
-    // Update the board state (simulate movement)
-    place_space->colour = pick_space->colour;
-    pick_space->colour = 0;
-
-    cout << "Movement completed!" << endl;
+    // Queue the move; with live colour detection on, it is only complete once the camera
+    // sees the block leave the pick space and arrive at the place space
+    PlannedMove move = { toGridCell(*pick_space), toGridCell(*place_space), 0, selectedColour };
+    submitPlan(queue, { move }, "Move " + blockName, milliseconds(2000));
 
     // Reset GUI selection
     selectedColour = 0;
     selectedRow = 0;
 }
 
-// Function to execute reset operation (move all blocks from C3 to C1)
-void executeReset(struct sp_port* port) {
+// Function to execute reset operation (move all blocks from the last column to C1)
+void executeReset(RobotCommandQueue& queue) {
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
+    }
     if (!spacesCalibrated || savedSpaces.empty()) {
         cout << "Matrix not calibrated yet!" << endl;
         return;
     }
 
-    // Find blocks in column 3 and empty positions in column 1
-    vector<Space*> blocksInC3 = findBlocksInColumn3();
-    vector<Space*> emptyPositionsInC1 = findEmptyPositionsInColumn1();
+    // Find blocks in the last column and empty positions in column 1
+    int lastCol = boardGeometry.cols;
+    vector<Space*> blocksInLastCol = findBlocksInColumn(lastCol);
+    vector<Space*> emptyPositionsInC1 = findEmptyPositionsInColumn(1);
 
-    if (blocksInC3.empty()) {
-        cout << "No blocks found in column 3 to reset!" << endl;
+    if (blocksInLastCol.empty()) {
+        cout << "No blocks found in column " << lastCol << " to reset!" << endl;
         return;
     }
 
@@ -611,122 +840,430 @@ void executeReset(struct sp_port* port) {
     }
 
     cout << "Starting reset operation..." << endl;
-    cout << "Found " << blocksInC3.size() << " blocks in column 3" << endl;
+    cout << "Found " << blocksInLastCol.size() << " blocks in column " << lastCol << endl;
     cout << "Found " << emptyPositionsInC1.size() << " empty positions in column 1" << endl;
 
-    // Move blocks from C3 to C1
-    for (size_t i = 0; i < min(blocksInC3.size(), emptyPositionsInC1.size()); i++) {
-        Space* pick_space = blocksInC3[i];
-        Space* place_space = emptyPositionsInC1[i];
+    // Pick the pairing and order with the shortest estimated arm time rather than index order
+    vector<GridCell> blocks, spaces;
+    for (Space* space : blocksInLastCol) blocks.push_back(toGridCell(*space));
+    for (Space* space : emptyPositionsInC1) spaces.push_back(toGridCell(*space));
+    bool framed = (queue.protocol == PROTOCOL_FRAMED);
+    MovePlan plan = planTransfers(blocks, spaces, moveCostModel, !framed);
+
+    for (PlannedMove& move : plan.moves) {
+        move.colour = findSpaceByPosition(move.pick.position_id)->colour;
+        cout << "Moving block from R" << move.pick.row << "C" << move.pick.col
+            << " to R" << move.place.row << "C" << move.place.col
+            << " (" << colourName(move.colour) << ", ~" << (int)move.estimatedMs << " ms)" << endl;
+    }
+    cout << "Estimated reset time: " << (int)plan.totalMs << " ms" << (plan.optimal ? "" : " (greedy plan)") << endl;
 
-        cout << "Moving block from R" << pick_space->row << "C" << pick_space->col
-            << " to R" << place_space->row << "C" << place_space->col << endl;
-        cout << "Block colour: " << colourNames[pick_space->colour] << endl;
+    submitPlan(queue, plan.moves, "Reset", milliseconds(15000));
+}
 
-        // Get the command for this specific movement
-        auto cmdIt = resetCmdMap.find({ pick_space->row, place_space->row });
-        if (cmdIt == resetCmdMap.end()) {
-            cout << "Error: No command found for movement from R" << pick_space->row
-                << " to R" << place_space->row << endl;
-            continue;
+// Function to find the single-byte command for a move; only C1 -> C3 and C3 -> C1 on the
+// 3x3 board have one
+bool legacyCodeForMove(const PlannedMove& move, unsigned char& cmd) {
+    if (!boardGeometry.legacyCommands()) return false;
+    if (move.pick.col == 1 && move.place.col == 3) cmd = pickPlaceCode(move.pick.row, move.place.row);
+    else if (move.pick.col == 3 && move.place.col == 1) cmd = resetCode(move.pick.row, move.place.row);
+    else return false;
+    return cmd != CMD_CLEAR;
+}
+
+// Function to rearrange the board into a requested layout. The layout has one character per
+// position_id in order: R, B or G for a block, '.' for an empty space and '*' for don't care
+void executeLayout(const string& layout, RobotCommandQueue& queue) {
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
+    }
+    if (!spacesCalibrated || savedSpaces.empty()) {
+        cout << "Matrix not calibrated yet!" << endl;
+        return;
+    }
+
+    // Cells and current colours in position_id order
+    vector<Space> spaces = savedSpaces;
+    sort(spaces.begin(), spaces.end(), [](const Space& a, const Space& b) { return a.position_id < b.position_id; });
+    if (layout.size() != spaces.size()) {
+        cout << "Layout needs " << spaces.size() << " characters (R, B, G, '.' or '*'), got \"" << layout << "\"" << endl;
+        return;
+    }
+
+    vector<GridCell> cells;
+    BoardLayout current, target;
+    for (size_t i = 0; i < spaces.size(); i++) {
+        cells.push_back(toGridCell(spaces[i]));
+        current.push_back(spaces[i].colour);
+
+        char c = (char)toupper(layout[i]);
+        if (c == 'R') target.push_back(1);
+        else if (c == 'B') target.push_back(2);
+        else if (c == 'G') target.push_back(3);
+        else if (c == '.' || c == 'N') target.push_back(0);
+        else if (c == '*') target.push_back(LAYOUT_ANY);
+        else {
+            cout << "Unknown layout character '" << layout[i] << "'" << endl;
+            return;
         }
+    }
 
-        unsigned char cmd = cmdIt->second;
-        cout << "Using command: " << int(cmd) << " for C3R" << pick_space->row
-            << " -> C1R" << place_space->row << endl;
+    // Legacy controllers only understand C1 -> C3 and C3 -> C1 moves, so plan with those.
+    // Large boards can take a while, so the search runs on the planner thread and the plan is
+    // queued from dispatchCompletions() once it is ready.
+    bool framed = (queue.protocol == PROTOCOL_FRAMED);
+    bool submitted = layoutPlanner.submit(cells, current, target, moveCostModel, !framed, !framed,
+        [layout, current, &queue](bool ok, const MovePlan& plan, const string& error) {
+            if (!ok) {
+                cout << "Cannot reach layout " << layout << ": " << error << endl;
+                return;
+            }
+            if (plan.moves.empty()) {
+                cout << "Board already matches layout " << layout << endl;
+                return;
+            }
 
-        // Send command sequence
-        if (port) {
-            sp_blocking_write(port, &cmd, 1, 100);
-            cout << "Command sent: " << int(cmd) << endl;
+            // The board or the robot may have changed while the search ran
+            vector<Space> spaces = savedSpaces;
+            sort(spaces.begin(), spaces.end(), [](const Space& a, const Space& b) { return a.position_id < b.position_id; });
+            BoardLayout now;
+            for (const Space& space : spaces) now.push_back(space.colour);
+            if (now != current || queue.busy()) {
+                cout << "Board changed while planning layout " << layout << "; request it again" << endl;
+                return;
+            }
 
-            // Wait for operation to complete
-            this_thread::sleep_for(milliseconds(15000));
+            for (const PlannedMove& move : plan.moves) {
+                cout << "Moving " << colourName(move.colour) << " block from R" << move.pick.row << "C" << move.pick.col
+                    << " to R" << move.place.row << "C" << move.place.col << " (~" << (int)move.estimatedMs << " ms)" << endl;
+            }
+            cout << "Estimated layout time: " << (int)plan.totalMs << " ms for " << plan.moves.size() << " moves" << endl;
 
-            // Send zero command
-            cmd = 0;
-            sp_blocking_write(port, &cmd, 1, 100);
-            sp_drain(port);
+            submitPlan(queue, plan.moves, "Layout", milliseconds(15000));
+        });
+    if (submitted) {
+        cout << "Planning layout " << layout << "..." << endl;
+    }
+    else {
+        cout << "Still planning the previous layout! Try again when it is done." << endl;
+    }
+}
 
-            cout << "Command reset" << endl;
+// Function to update the board state after moves the camera did not confirm (simulate movement)
+void applyMoves(const vector<PlannedMove>& moves) {
+    for (const PlannedMove& move : moves) {
+        Space* pick_space = findSpaceByPosition(move.pick.position_id);
+        Space* place_space = findSpaceByPosition(move.place.position_id);
+        if (pick_space && place_space) {
+            place_space->colour = pick_space->colour;
+            pick_space->colour = 0;
         }
-        else {
-            cout << "Serial port not available!" << endl;
+    }
+}
+
+// Function to list the spaces whose colour a plan changes, as the camera should see them at
+// the end; blocks may pass through a space more than once, so only the final state counts
+vector<ExpectedSpace> expectedAfter(const vector<PlannedMove>& moves) {
+    map<int, int> finalColours;
+    for (const PlannedMove& move : moves) {
+        finalColours[move.pick.position_id] = 0;
+        finalColours[move.place.position_id] = move.colour;
+    }
+    vector<ExpectedSpace> expected;
+    for (const auto& entry : finalColours) {
+        Space* space = findSpaceByPosition(entry.first);
+        if (!space || space->colour != entry.second) expected.push_back({ entry.first, entry.second });
+    }
+    return expected;
+}
+
+// Function to queue a plan of moves, each carrying the colour of its block. The framed
+// protocol takes the whole plan as one command, so the controller runs the moves back to back
+// without a round trip and a settle pause between them; legacy controllers get one command
+// per move, and their real durations refine the cost model.
+void submitPlan(RobotCommandQueue& queue, const vector<PlannedMove>& moves, const string& label, milliseconds holdPerMove) {
+    if (moves.empty()) return;
+
+    if (queue.protocol == PROTOCOL_FRAMED) {
+        RobotCommand command = { 0, holdPerMove * (int)moves.size(), milliseconds(0), label };
+        for (const PlannedMove& move : moves) {
+            command.ops.push_back({ (uint8_t)move.pick.position_id, (uint8_t)move.place.position_id });
+        }
+        if (continuousColourDetection) {
+            command.expected = expectedAfter(moves);
         }
 
-        // Update the board state (simulate movement)
-        place_space->colour = pick_space->colour;
-        pick_space->colour = 0;
+        queue.submit(command, [moves](const RobotCommand& command, const CommandResult& result) {
+            if (!result.ok) {
+                cout << command.label << " failed: " << result.message << endl;
+                return;
+            }
+            if (!result.confirmed) {
+                applyMoves(moves);
+            }
+            cout << command.label << " completed in " << result.elapsed.count() << " ms with "
+                << moves.size() << (moves.size() == 1 ? " move." : " moves.") << endl;
+            });
+        return;
+    }
 
-        cout << "Movement " << (i + 1) << " completed!" << endl;
+    // Check every move has a single-byte command before any of them is queued
+    vector<unsigned char> codes;
+    for (const PlannedMove& move : moves) {
+        unsigned char cmd = CMD_CLEAR;
+        if (!legacyCodeForMove(move, cmd)) {
+            cout << "Error: No command found for movement from R" << move.pick.row << "C" << move.pick.col
+                << " to R" << move.place.row << "C" << move.place.col << endl;
+            return;
+        }
+        codes.push_back(cmd);
+    }
 
-        // Small delay between movements
-        if (i < min(blocksInC3.size(), emptyPositionsInC1.size()) - 1) {
-            this_thread::sleep_for(milliseconds(1000));
+    // Queue one command per move; each waits for the settle time after the previous one
+    size_t moveCount = moves.size();
+    double armRow = moveCostModel.homeRow, armCol = moveCostModel.homeCol;
+    for (size_t i = 0; i < moveCount; i++) {
+        const PlannedMove& planned = moves[i];
+        cout << "Using command: " << int(codes[i]) << " for R" << planned.pick.row << "C" << planned.pick.col
+            << " -> R" << planned.place.row << "C" << planned.place.col << endl;
+
+        bool last = (i == moveCount - 1);
+        milliseconds settle = last ? milliseconds(0) : milliseconds((int)moveCostModel.settleMs);
+        string moveLabel = moveCount > 1 ? label + " move " + to_string(i + 1) : label;
+
+        RobotCommand move = { codes[i], holdPerMove, settle, moveLabel };
+        move.ops = { { (uint8_t)planned.pick.position_id, (uint8_t)planned.place.position_id } };
+        if (continuousColourDetection) {
+            move.expected = { { planned.pick.position_id, 0 }, { planned.place.position_id, planned.colour } };
         }
+
+        queue.submit(move,
+            [planned, armRow, armCol, last, moveCount, label](const RobotCommand& command, const CommandResult& result) {
+                if (!result.ok) {
+                    cout << command.label << " failed: " << result.message << endl;
+                    if (moveCount > 1 && result.message != "Cancelled") {
+                        cout << label << " aborted, remaining moves cancelled." << endl;
+                    }
+                    return;
+                }
+
+                // Real durations refine the estimates used by the next plan; a command that only
+                // ran out its hold time says nothing about how long the move took
+                if (result.observedEnd) {
+                    moveCostModel.observe(planned.pick, planned.place, armRow, armCol, (double)result.elapsed.count());
+                }
+                if (!result.confirmed) {
+                    applyMoves({ planned });
+                }
+
+                cout << command.label << " completed!" << endl;
+                if (last && moveCount > 1) {
+                    cout << label << " completed with " << moveCount << " moves." << endl;
+                }
+            });
+        armRow = planned.place.row;
+        armCol = planned.place.col;
+    }
+}
+
+// Function to send the robot to its home position
+void executeHome(RobotCommandQueue& queue) {
+    if (queue.busy()) {
+        cout << "Robot is busy! Wait for the current command to finish." << endl;
+        return;
     }
 
-    cout << "Reset operation completed! Moved "
-        << min(blocksInC3.size(), emptyPositionsInC1.size()) << " blocks from C3 to C1." << endl;
+    queue.submit({ CMD_HOME, milliseconds(2000), milliseconds(0), "Home" },
+        [](const RobotCommand& command, const CommandResult& result) {
+            if (result.ok) {
+                cout << "Home position set!" << endl;
+            }
+            else {
+                cout << command.label << " failed: " << result.message << endl;
+            }
+        });
 }
 
 int main(int argc, char* argv[])
 {
-    if (!global_cap.isOpened()) {
+    if (!global_grabber.open(0)) {
         cout << "Cannot open camera" << endl;
         return -1;
     }
-
-    struct sp_port* port = nullptr;
-    int err;
-
-    // Initialize serial port (optional - can run without it)
-    if (argc >= 2) {
-        err = sp_get_port_by_name("COM3", &port);
-        if (err == SP_OK) {
-            err = sp_open(port, SP_MODE_WRITE);
-            if (err == SP_OK) {
-                sp_set_baudrate(port, BAUD);
-                sp_set_bits(port, 8);
-                cout << "Serial port initialized successfully" << endl;
+    global_grabber.start();
+
+    // --headless runs without windows and --gui with them. Serial options (--port, --baud,
+    // --parity, --stopbits, --flow, --write-timeout, --read-timeout, --serial-config <file>)
+    // configure the ports;
+    // --vision-hz (0 = every camera frame), --display-hz and --gui-hz set the loop rates;
+    // --board <rows>x<cols> sets the board size (3x3 unless given);
+    // any other argument enables the default port (COM3 at 9600 8N1)
+    bool headless = ROBOT_HEADLESS_DEFAULT;
+    bool useSerial = false;
+    double visionHz = 0, displayHz = 12, guiHz = 60;
+    vector<SerialConfig> serialConfigs;
+    for (int i = 1; i < argc; i++) {
+        bool badOption = false;
+        string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        }
+        else if (arg == "--gui") {
+            headless = false;
+        }
+        else if ((arg == "--vision-hz" || arg == "--display-hz" || arg == "--gui-hz") && i + 1 < argc) {
+            double& hz = (arg == "--vision-hz") ? visionHz : (arg == "--display-hz") ? displayHz : guiHz;
+            if (!parseRate(argv[++i], hz)) {
+                cout << "Bad value for " << arg << ": " << argv[i] << endl;
+                return -1;
             }
-            else {
-                cout << "Warning: Could not open serial port" << endl;
-                port = nullptr;
+        }
+        else if (arg == "--board" && i + 1 < argc) {
+            if (!parseBoardGeometry(argv[++i], boardGeometry)) {
+                cout << "Bad board size: " << argv[i] << " (use <rows>x<cols>, at most "
+                    << MAX_BOARD_SPACES << " spaces)" << endl;
+                return -1;
             }
         }
+        else if (parseSerialArg(argc, argv, i, serialConfigs, badOption)) {
+            if (badOption) return -1;
+            useSerial = true;
+        }
         else {
-            cout << "Warning: Could not find serial port" << endl;
-            port = nullptr;
+            useSerial = true;
+        }
+    }
+
+    // Initialize serial ports (optional - can run without them)
+    SerialPortSet serialPorts;
+    struct sp_port* port = nullptr;
+    if (useSerial) {
+        if (serialConfigs.empty()) {
+            serialConfigs.push_back(SerialConfig());
+        }
+        // Open for reading too so the controller can acknowledge finished moves
+        serialPorts.openAll(serialConfigs, SP_MODE_READ_WRITE);
+
+        // Commands go to the port named "robot", or the first one configured
+        size_t robotPort = 0;
+        for (size_t i = 0; i < serialPorts.size(); i++) {
+            if (serialPorts.config(i).name == SerialConfig().name) {
+                robotPort = i;
+                break;
+            }
+        }
+        port = serialPorts.port(robotPort);
+        robotQueue.writeTimeoutMs = serialPorts.config(robotPort).writeTimeoutMs;
+        robotQueue.readTimeoutMs = serialPorts.config(robotPort).readTimeoutMs;
+        robotQueue.protocol = serialPorts.config(robotPort).framedProtocol ? PROTOCOL_FRAMED : PROTOCOL_LEGACY;
+        if (!port) {
+            cout << "Warning: Robot serial port unavailable. Running in simulation mode." << endl;
         }
     }
     else {
         cout << "Warning: No serial port specified. Running in simulation mode." << endl;
     }
 
+    // Single-byte commands only address the 3x3 board; larger boards need framed plans
+    if (!boardGeometry.legacyCommands()) {
+        if (port && robotQueue.protocol == PROTOCOL_LEGACY) {
+            cout << "A " << boardGeometry.rows << "x" << boardGeometry.cols
+                << " board needs a controller on the framed protocol (--protocol framed)" << endl;
+            serialPorts.closeAll();
+            global_grabber.stop();
+            return -1;
+        }
+        robotQueue.protocol = PROTOCOL_FRAMED;
+    }
+    moveCostModel.homeRow = (boardGeometry.rows + 1) / 2.0;
+    moveCostModel.homeCol = (boardGeometry.cols + 1) / 2.0;
+
     cout << "Robot Control System Started" << endl;
-    cout << "Calibrate matrix to start" << endl;
+    if (loadSavedCalibration(global_grabber)) {
+        continuousColourDetection = true;
+        cout << "Continuous colour detection started automatically" << endl;
+    }
+    else {
+        cout << "Calibrate matrix to start" << endl;
+    }
 
-    // Create control panel window
-    namedWindow("Control Panel", WINDOW_NORMAL);
-    resizeWindow("Control Panel", 400, 600);
-    setMouseCallback("Control Panel", onMouse, port);
+    // Ensure cmd = 0 first; only legacy controllers use the 0 byte, framed ones expect frames
+    if (port && robotQueue.protocol == PROTOCOL_LEGACY) {
+        unsigned char cmd = 0;
+        sp_blocking_write(port, &cmd, 1, robotQueue.writeTimeoutMs);
+    }
 
-    // Create live feed window
-    namedWindow("Live Feed", WINDOW_NORMAL);
+    // Robot commands run on their own thread from here on; acknowledgements from the
+    // controller end each command early, older firmware falls back to the fixed times
+    robotQueue.start(port, true);
+    layoutPlanner.start();
 
-    // Ensure cmd = 0 first
-    unsigned char cmd = 0;
-    if (port) {
-        sp_blocking_write(port, &cmd, 1, 100);
+    if (headless) {
+        runHeadless(robotQueue, visionHz);
     }
+    else {
+        // Create control panel window
+        namedWindow("Control Panel", WINDOW_NORMAL);
+        resizeWindow("Control Panel", 400, 600);
+        setMouseCallback("Control Panel", onMouse, &robotQueue);
+        createControlPanel();
 
-    while (true) {
-        Mat liveFrame;
-        if (global_cap.read(liveFrame)) {
+        // Create live feed window
+        namedWindow("Live Feed", WINDOW_NORMAL);
+    }
+
+    // Vision, display and GUI events each run on their own cadence, so drawing and imshow at
+    // the display rate no longer hold back colour detection at the camera rate
+    Cadence visionCadence(visionHz), displayCadence(displayHz), guiCadence(guiHz);
+    Mat liveFrame;
+    bool frameToDisplay = false;
+    unsigned long long liveFrameHandover = 0;
+
+    while (!headless) {
+        // Only iterations that did vision, display or GUI work count towards the loop time;
+        // the idle ones in between would otherwise drown it in 1 ms sleeps
+        StageProfiler::Clock::time_point loopStart = StageProfiler::Clock::now();
+        bool didWork = false;
+
+        // Apply the results of any robot commands and layout searches that finished since the last frame
+        robotQueue.dispatchCompletions();
+        layoutPlanner.dispatchCompletions();
+
+        // Without the camera watching, moves waiting for confirmation end on the robot's ack
+        robotQueue.setConfirmationAvailable(spacesCalibrated && continuousColourDetection);
+
+        // Take the newest captured frame; older ones have already been dropped
+        StageProfiler::Clock::time_point now = StageProfiler::Clock::now();
+        StageProfiler::Clock::time_point capturedAt;
+        if (visionCadence.ready(now) && global_grabber.acquireLatest(liveFrame, &capturedAt)) {
+            visionCadence.consume(now);
+            profiler.record(STAGE_FRAME_AGE, capturedAt, StageProfiler::Clock::now());
+
+            if (spacesCalibrated && continuousColourDetection) {
+                StageProfiler::Scope timer(profiler, STAGE_COLOUR_CHECK);
+                updateSpaceColours(liveFrame);
+                verifyActiveCommand();
+            }
+            frameToDisplay = true;
+            liveFrameHandover = global_grabber.framesHandedOver();
+            didWork = true;
+        }
+
+        // Calibration and the empty-board capture acquire frames of their own from the GUI
+        // handlers, which hands liveFrame's buffer back to the capture thread; drop it then
+        if (global_grabber.framesHandedOver() != liveFrameHandover) {
+            liveFrame.release();
+            frameToDisplay = false;
+        }
+
+        // Overlays are drawn straight onto the newest frame, which the grabber leaves alone
+        // until another frame is acquired (checked above), and each frame is shown at most once
+        if (frameToDisplay && displayCadence.due(StageProfiler::Clock::now())) {
+            StageProfiler::Clock::time_point overlayStart = StageProfiler::Clock::now();
             if (spacesCalibrated) {
                 if (continuousColourDetection) {
-                    checkSpaceColoursLive(liveFrame);
+                    drawSpaceColours(liveFrame);
                 }
                 else {
                     for (size_t i = 0; i < savedSpaces.size(); i++) {
@@ -737,34 +1274,65 @@ int main(int argc, char* argv[])
                 }
 
                 // Display current selection on live feed
-                string colourName = (selectedColour > 0) ? colourNames[selectedColour] : "None";
-                string selectionText = "Selection: " + colourName + " -> Row " + to_string(selectedRow);
+                string selectionText = string("Selection: ") + colourName(selectedColour) + " -> Row " + to_string(selectedRow);
                 putText(liveFrame, selectionText, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 0), 2);
             }
             else {
                 putText(liveFrame, "Calibrate Matrix in Control Panel",
                     Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 0, 255), 2);
             }
+            if (showLatencyOverlay) {
+                profiler.drawOverlay(liveFrame, Point(10, liveFrame.rows - 15 * (int)profiler.stageCount() - 10));
+            }
+            profiler.record(STAGE_OVERLAY, overlayStart, StageProfiler::Clock::now());
 
+            StageProfiler::Scope timer(profiler, STAGE_IMSHOW);
             imshow("Live Feed", liveFrame);
+            frameToDisplay = false;
+            didWork = true;
+        }
+
+        profiler.dumpIfDue(LATENCY_FILE, seconds(5));
+
+        if (!guiCadence.due(StageProfiler::Clock::now())) {
+            if (didWork) {
+                profiler.record(STAGE_LOOP, loopStart, StageProfiler::Clock::now());
+            }
+            else {
+                this_thread::sleep_for(milliseconds(1));
+            }
+            continue;
         }
 
         // Update control panel
-        createControlPanel();
+        {
+            StageProfiler::Scope timer(profiler, STAGE_CONTROL_PANEL);
+            updateControlPanel();
+        }
 
-        int key = waitKey(30);
+        // Mouse clicks and keys are handled here; waitKey(1) only pumps the event queue
+        int key;
+        {
+            StageProfiler::Scope timer(profiler, STAGE_WAITKEY);
+            key = waitKey(1);
+        }
+        profiler.record(STAGE_LOOP, loopStart, StageProfiler::Clock::now());
 
+        if (key == 'l' || key == 'L') {
+            showLatencyOverlay = !showLatencyOverlay;
+        }
         if (key == 'q' || key == 'Q' || key == 27) {
             cout << "Quitting..." << endl;
-            if (port) {
-                sp_close(port);
-            }
             break;
         }
     }
 
-    if (port) {
-        sp_close(port);
-    }
+    // Let the robot finish its current command before the port is closed, but no more than
+    // 20 s so a controller that stopped answering cannot hang the exit
+    layoutPlanner.stop();
+    robotQueue.setConfirmationAvailable(false); // The camera is no longer being read
+    robotQueue.stop(seconds(20));
+    global_grabber.stop();
+    serialPorts.closeAll();
     return 0;
 }
@@ -1,785 +0,0 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <libserialport.h>
-#include "opencv2/highgui/highgui.hpp"
-#include "opencv2/imgproc/imgproc.hpp"
-#include <iostream>
-#include <vector>
-#include <map>
-#include <thread>
-#include <chrono>
-
-#define BAUD 9600
-
-using namespace cv;
-using namespace std;
-using namespace std::chrono;
-
-// ===================================================================================
-//                        STRUCTURES AND GLOBALS
-// ===================================================================================
-
-// Structure to store space information
-struct Space {
-    Point2f center;
-    double area;
-    int colour;
-    int row;
-    int col;
-    int position_id; // 1-9 for 3x3 grid
-};
-
-// Global variables
-vector<Space> savedSpaces;
-bool spacesCalibrated = false;
-Mat emptyFrame;
-bool emptyFrameCaptured = false;
-bool continuousColourDetection = false;
-VideoCapture global_cap(0); // Global camera object
-
-// GUI state variables
-int selectedColour = 0; // 0=None, 1=Red, 2=Blue, 3=Green
-int selectedRow = 0;   // 0=None, 1-3=Row number
-
-// Button regions for mouse clicks
-Rect calibrateBtn = Rect(50, 100, 300, 50);
-Rect colourRedBtn = Rect(50, 200, 80, 30);
-Rect colourBlueBtn = Rect(140, 200, 80, 30);
-Rect colourGreenBtn = Rect(230, 200, 80, 30);
-Rect row1Btn = Rect(50, 250, 80, 30);
-Rect row2Btn = Rect(140, 250, 80, 30);
-Rect row3Btn = Rect(230, 250, 80, 30);
-Rect executeBtn = Rect(50, 300, 300, 50);
-Rect resetBtn = Rect(50, 370, 140, 40);
-Rect homeBtn = Rect(200, 370, 140, 40);
-Rect colourDetectionBtn = Rect(50, 450, 300, 30);
-
-// Colour mapping
-map<int, string> colourNames = {
-    {1, "Red"},
-    {2, "Blue"},
-    {3, "Green"},
-    {0, "None"}
-};
-
-// Position mapping: row and column to position_id
-map<pair<int, int>, int> positionMap = {
-    {{1, 1}, 1}, {{1, 2}, 2}, {{1, 3}, 3},
-    {{2, 1}, 4}, {{2, 2}, 5}, {{2, 3}, 6},
-    {{3, 1}, 7}, {{3, 2}, 8}, {{3, 3}, 9}
-};
-
-// Reset command mapping: (pick_row, place_row) -> cmd
-map<pair<int, int>, unsigned char> resetCmdMap = {
-    {{1, 1}, 129}, // C3R1 -> C1R1
-    {{1, 2}, 130}, // C3R1 -> C1R2
-    {{1, 3}, 131}, // C3R1 -> C1R3
-    {{2, 1}, 133}, // C3R2 -> C1R1
-    {{2, 2}, 134}, // C3R2 -> C1R2
-    {{2, 3}, 135}, // C3R2 -> C1R3
-    {{3, 1}, 137}, // C3R3 -> C1R1
-    {{3, 2}, 138}, // C3R3 -> C1R2
-    {{3, 3}, 139}  // C3R3 -> C1R3
-};
-
-// ===================================================================================
-//                        FORWARD DECLARATIONS
-// ===================================================================================
-
-bool captureEmptyFrame(VideoCapture& cap);
-void executeMove(struct sp_port* port);
-void executeReset(struct sp_port* port);
-int getPositionId(int row, int col);
-Space* findBlockByColour(int colourCode);
-vector<Space*> findBlocksInColumn3();
-vector<Space*> findEmptyPositionsInColumn1();
-void checkSpaceColoursLive(Mat& liveFrame);
-int detectColour(Mat& original, int x, int y);
-vector<Point> detectBoard(Mat& thresholded, Mat& original);
-vector<Space> detectSpacesInBoard(Mat& thresholded, Mat& original, const vector<Point>& boardContour);
-
-// ===================================================================================
-//                        GUI AND MOUSE HANDLING
-// ===================================================================================
-// Mouse callback for control panel
-void onMouse(int event, int x, int y, int flags, void* userdata) {
-    if (event == EVENT_LBUTTONDOWN) {
-        Point pt(x, y);
-        struct sp_port* port = (struct sp_port*)userdata;
-        
-        // Check which button was clicked
-        if (calibrateBtn.contains(pt)) {
-            cout << "Calibrating matrix..." << endl;
-            if (captureEmptyFrame(global_cap)) {
-                cout << "Calibration successful!" << endl;
-                continuousColourDetection = true;
-                cout << "Continuous colour detection started automatically" << endl;
-            }
-            else {
-                cout << "Calibration failed. Adjust camera/view and try again." << endl;
-            }
-        }
-        else if (colourRedBtn.contains(pt)) {
-            selectedColour = 1;
-            cout << "Selected: Red" << endl;
-        }
-        else if (colourBlueBtn.contains(pt)) {
-            selectedColour = 2;
-            cout << "Selected: Blue" << endl;
-        }
-        else if (colourGreenBtn.contains(pt)) {
-            selectedColour = 3;
-            cout << "Selected: Green" << endl;
-        }
-        else if (row1Btn.contains(pt)) {
-            selectedRow = 1;
-            cout << "Selected: Row 1" << endl;
-        }
-        else if (row2Btn.contains(pt)) {
-            selectedRow = 2;
-            cout << "Selected: Row 2" << endl;
-        }
-        else if (row3Btn.contains(pt)) {
-            selectedRow = 3;
-            cout << "Selected: Row 3" << endl;
-        }
-        else if (executeBtn.contains(pt)) {
-            cout << "Executing move..." << endl;
-            executeMove(port);
-        }
-        else if (resetBtn.contains(pt)) {
-            cout << "Executing reset..." << endl;
-            executeReset(port);
-        }
-        else if (homeBtn.contains(pt)) {
-            cout << "Going home..." << endl;
-            if (port) {
-                unsigned char cmd = 64;
-                sp_blocking_write(port, &cmd, 1, 100);
-                this_thread::sleep_for(milliseconds(2000));
-                cmd = 0;
-                sp_blocking_write(port, &cmd, 1, 100);
-                cout << "Home position set!" << endl;
-            }
-        }
-        else if (colourDetectionBtn.contains(pt)) {
-            if (spacesCalibrated) {
-                continuousColourDetection = !continuousColourDetection;
-                cout << "Continuous colour detection: " << (continuousColourDetection ? "ON" : "OFF") << endl;
-            }
-            else {
-                cout << "Please calibrate matrix first!" << endl;
-            }
-        }
-    }
-}
-
-// Creates and displays the control panel GUI
-void createControlPanel() {
-    Mat controlPanel = Mat::zeros(600, 400, CV_8UC3);
-    controlPanel.setTo(Scalar(60, 60, 60));
-
-    // Title
-    putText(controlPanel, "Robot Control Panel", Point(20, 30),
-        FONT_HERSHEY_SIMPLEX, 0.7, Scalar(255, 255, 255), 2);
-
-    // Calibration section
-    rectangle(controlPanel, calibrateBtn, Scalar(100, 100, 100), -1);
-    rectangle(controlPanel, calibrateBtn, Scalar(200, 200, 200), 2);
-    putText(controlPanel, "Calibrate Matrix", Point(60, 130),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
-
-    // Status
-    string statusText = spacesCalibrated ? "CALIBRATED" : "NOT CALIBRATED";
-    Scalar statusColour = spacesCalibrated ? Scalar(0, 255, 0) : Scalar(0, 0, 255);
-    putText(controlPanel, statusText, Point(20, 80),
-        FONT_HERSHEY_SIMPLEX, 0.5, statusColour, 1);
-
-    // Colour selection
-    putText(controlPanel, "Select Colour:", Point(20, 180),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
-
-    // Colour buttons
-    rectangle(controlPanel, colourRedBtn, selectedColour == 1 ? Scalar(0, 0, 255) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourRedBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Red", Point(65, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, colourBlueBtn, selectedColour == 2 ? Scalar(255, 0, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourBlueBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Blue", Point(155, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, colourGreenBtn, selectedColour == 3 ? Scalar(0, 255, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourGreenBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Green", Point(245, 220), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-    
-    // Row selection
-    putText(controlPanel, "Select Target Location:", Point(20, 240),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, row1Btn, selectedRow == 1 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row1Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,1", Point(65, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, row2Btn, selectedRow == 2 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row2Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,2", Point(155, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, row3Btn, selectedRow == 3 ? Scalar(100, 100, 200) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, row3Btn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "3,3", Point(245, 270), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    // Execute button
-    bool canExecute = (selectedColour > 0 && selectedRow > 0 && spacesCalibrated);
-    rectangle(controlPanel, executeBtn, canExecute ? Scalar(0, 100, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, executeBtn, Scalar(200, 200, 200), 2);
-    putText(controlPanel, "EXECUTE MOVE", Point(80, 330),
-        FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 255), 1);
-
-    // Current selection display
-    string selectionText = "Current: " + colourNames[selectedColour] + " -> Row " + to_string(selectedRow);
-    putText(controlPanel, selectionText, Point(20, 360),
-        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 0), 1);
-
-    // Special commands
-    rectangle(controlPanel, resetBtn, spacesCalibrated ? Scalar(0, 0, 100) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, resetBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "RESET", Point(70, 395), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    rectangle(controlPanel, homeBtn, Scalar(100, 0, 0), -1);
-    rectangle(controlPanel, homeBtn, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "HOME", Point(230, 395), FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    // Colour detection toggle
-    rectangle(controlPanel, colourDetectionBtn, continuousColourDetection ? Scalar(0, 100, 0) : Scalar(50, 50, 50), -1);
-    rectangle(controlPanel, colourDetectionBtn, Scalar(200, 200, 200), 1);
-    string detectionText = continuousColourDetection ? "Colour Detection: ON" : "Colour Detection: OFF";
-    putText(controlPanel, detectionText, Point(60, 470),
-        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-
-    // Instructions
-    putText(controlPanel, "Instructions:", Point(20, 520),
-        FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-    putText(controlPanel, "ENSURE MATRIX IS EMPTY WHEN CALIBRATING!", Point(20, 540),
-        FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Greyed out buttons = disabled", Point(20, 560),
-        FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
-    putText(controlPanel, "Press 'q' in any window to quit", Point(20, 580),
-        FONT_HERSHEY_SIMPLEX, 0.3, Scalar(200, 200, 200), 1);
-
-    imshow("Control Panel", controlPanel);
-}
-
-// ===================================================================================
-//                        VISION PROCESSING FUNCTIONS
-// ===================================================================================
-// Detects colour at specific coordinates and returns integer (0=None, 1=Red, 2=Blue, 3=Green)
-int detectColour(Mat& original, int x, int y) {
-    if (x < 0 || x >= original.cols || y < 0 || y >= original.rows) {
-        return 0;
-    }
-
-    Mat hsv;
-    cvtColour(original, hsv, COLOR_BGR2HSV);
-
-    Vec3b pixel = hsv.at<Vec3b>(y, x);
-    int hue = pixel[0];
-    int saturation = pixel[1];
-    int value = pixel[2];
-
-    if ((hue >= 140 && hue <= 180) && saturation > 100 && value > 50) {
-        return 1; // Red
-    }
-    else if (hue >= 100 && hue <= 135 && saturation > 100 && value > 50) {
-        return 2; // Blue
-    }
-    else if (hue >= 30 && hue <= 80 && saturation > 100 && value > 50) {
-        return 3; // Green
-    }
-
-    return 0;
-}
-
-// Detects the largest dark object (board) in the thresholded image
-vector<Point> detectBoard(Mat& thresholded, Mat& original) {
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
-
-    findContours(thresholded, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-
-    double maxArea = 0;
-    int maxAreaIdx = -1;
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area > maxArea) {
-            maxArea = area;
-            maxAreaIdx = i;
-        }
-    }
-
-    if (maxAreaIdx >= 0 && maxArea > 10000) {
-        drawContours(original, contours, maxAreaIdx, Scalar(0, 255, 255), 3);
-        return contours[maxAreaIdx];
-    }
-
-    return vector<Point>();
-}
-
-// Detects spaces within the board region
-vector<Space> detectSpacesInBoard(Mat& thresholded, Mat& original, const vector<Point>& boardContour) {
-    vector<Space> spaces;
-
-    if (boardContour.empty()) return spaces;
-
-    Mat boardMask = Mat::zeros(thresholded.size(), CV_8UC1);
-    vector<vector<Point>> boardContours = { boardContour };
-    fillPoly(boardMask, boardContours, Scalar(255));
-
-    vector<vector<Point>> contours;
-    vector<Vec4i> hierarchy;
-
-    Mat spacesImage;
-    bitwise_not(thresholded, spacesImage);
-    bitwise_and(spacesImage, boardMask, spacesImage);
-
-    findContours(spacesImage, contours, hierarchy, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area < 100 || area > 10000) continue;
-
-        Point2f center;
-        float radius;
-        minEnclosingCircle(contours[i], center, radius);
-
-        if (pointPolygonTest(boardContour, center, false) >= 0) {
-            double perimeter = arcLength(contours[i], true);
-            double circularity = 0;
-            if (perimeter > 0) {
-                circularity = (4 * CV_PI * area) / (perimeter * perimeter);
-            }
-
-            if (circularity > 0.5) {
-                Space space;
-                space.center = center;
-                space.area = area;
-                space.colour = 0;
-                spaces.push_back(space);
-            }
-        }
-    }
-
-    return spaces;
-}
-
-// Captures and processes empty frame for detecting and calibrating spaces
-bool captureEmptyFrame(VideoCapture& cap) {
-    Mat frame;
-    if (!cap.read(frame)) {
-        cout << "Cannot read frame from camera" << endl;
-        return false;
-    }
-
-    emptyFrame = frame.clone();
-    emptyFrameCaptured = true;
-
-    cout << "Empty frame captured! Processing spaces..." << endl;
-
-    Mat imgHSV;
-    cvtColour(emptyFrame, imgHSV, COLOR_BGR2HSV);
-
-    Mat imgThresholded;
-    inRange(imgHSV, Scalar(0, 0, 0), Scalar(179, 255, 100), imgThresholded);
-
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
-    morphologyEx(imgThresholded, imgThresholded, MORPH_CLOSE, kernel);
-    morphologyEx(imgThresholded, imgThresholded, MORPH_OPEN, kernel);
-
-    vector<Point> boardContour = detectBoard(imgThresholded, emptyFrame);
-    savedSpaces = detectSpacesInBoard(imgThresholded, emptyFrame, boardContour);
-
-    if (!savedSpaces.empty()) {
-        spacesCalibrated = true;
-        cout << "Successfully detected " << savedSpaces.size() << " spaces!" << endl;
-
-        // Sort spaces by position (left to right, top to bottom)
-        sort(savedSpaces.begin(), savedSpaces.end(), [](const Space& a, const Space& b) {
-            if (a.center.y == b.center.y) return a.center.x < b.center.x;
-            return a.center.y < b.center.y;
-            });
-
-        // Assign grid positions (1-9 for 3x3 grid)
-        for (size_t i = 0; i < savedSpaces.size(); i++) {
-            savedSpaces[i].row = (i / 3) + 1;
-            savedSpaces[i].col = 3 - (i % 3);
-            savedSpaces[i].position_id = positionMap[{savedSpaces[i].row, savedSpaces[i].col}];
-        }
-
-        for (size_t i = 0; i < savedSpaces.size(); i++) {
-            circle(emptyFrame, savedSpaces[i].center, 8, Scalar(0, 255, 0), 2);
-            string label = to_string(savedSpaces[i].row) + "," + to_string(savedSpaces[i].col) +
-                " (" + to_string(savedSpaces[i].position_id) + ")";
-            putText(emptyFrame, label, Point(savedSpaces[i].center.x + 10, savedSpaces[i].center.y),
-                FONT_HERSHEY_SIMPLEX, 0.5, Scalar(0, 255, 0), 2);
-        }
-
-        return true;
-    }
-    else {
-        cout << "No spaces detected in empty frame!" << endl;
-        return false;
-    }
-}
-
-// Checks colours at saved space positions on live feed and updates display
-void checkSpaceColoursLive(Mat& liveFrame) {
-    if (!spacesCalibrated || savedSpaces.empty()) return;
-
-    for (size_t i = 0; i < savedSpaces.size(); i++) {
-        int colourResult = detectColour(liveFrame, savedSpaces[i].center.x, savedSpaces[i].center.y);
-        savedSpaces[i].colour = colourResult;
-
-        Scalar colour;
-        string colourText;
-        switch (colourResult) {
-        case 1: colour = Scalar(0, 0, 255); colourText = "R"; break;
-        case 2: colour = Scalar(255, 0, 0); colourText = "B"; break;
-        case 3: colour = Scalar(0, 255, 0); colourText = "G"; break;
-        default: colour = Scalar(128, 128, 128); colourText = "N"; break;
-        }
-
-        circle(liveFrame, savedSpaces[i].center, 15, colour, -1);
-        circle(liveFrame, savedSpaces[i].center, 15, Scalar(255, 255, 255), 2);
-
-        string label = to_string(savedSpaces[i].row) + "," + to_string(savedSpaces[i].col);
-        putText(liveFrame, label, Point(savedSpaces[i].center.x - 10, savedSpaces[i].center.y + 5),
-            FONT_HERSHEY_SIMPLEX, 0.4, Scalar(255, 255, 255), 1);
-    }
-}
-
-// ===================================================================================
-//                        BOARD ANALYSIS FUNCTIONS
-// ===================================================================================
-
-// Returns position_id from row and column coordinates
-int getPositionId(int row, int col) {
-    auto it = positionMap.find({ row, col });
-    if (it != positionMap.end()) {
-        return it->second;
-    }
-    return -1; // Invalid position
-}
-
-// Finds a block of specified colour in column 1
-Space* findBlockByColour(int colourCode) {
-    for (auto& space : savedSpaces) {
-        if (space.col == 1 && space.colour == colourCode) {
-            return &space;
-        }
-    }
-    return nullptr;
-}
-
-// Finds all blocks in column 3 (for reset operation)
-vector<Space*> findBlocksInColumn3() {
-    vector<Space*> blocks;
-    for (auto& space : savedSpaces) {
-        if (space.col == 3 && space.colour != 0) {
-            blocks.push_back(&space);
-        }
-    }
-    return blocks;
-}
-
-// Finds empty positions in column 1 (for reset operation)
-vector<Space*> findEmptyPositionsInColumn1() {
-    vector<Space*> emptyPositions;
-    for (auto& space : savedSpaces) {
-        if (space.col == 1 && space.colour == 0) {
-            emptyPositions.push_back(&space);
-        }
-    }
-    return emptyPositions;
-}
-
-// ===================================================================================
-//                        ROBOT CONTROL FUNCTIONS
-// ===================================================================================
-
-// Executes movement based on GUI selection (colour block to target row in column 3)
-void executeMove(struct sp_port* port) {
-    if (selectedColour == 0 || selectedRow == 0) {
-        cout << "Please select both colour and row first!" << endl;
-        return;
-    }
-
-    if (!spacesCalibrated || savedSpaces.empty()) {
-        cout << "Matrix not calibrated yet!" << endl;
-        return;
-    }
-
-    string colourName = colourNames[selectedColour];
-    cout << "Executing move: " << colourName << " block to row " << selectedRow << " column 3" << endl;
-
-    // Find the block to pick in column 1
-    Space* pick_space = findBlockByColour(selectedColour);
-    if (!pick_space) {
-        cout << "No " << colourName << " block found in column 1!" << endl;
-        return;
-    }
-
-    // Find the place position in column 3
-    int place_position = getPositionId(selectedRow, 3);
-    if (place_position == -1) {
-        cout << "Error: Could not find position for row " << selectedRow << " column 3." << endl;
-        return;
-    }
-
-    // Find the place space object
-    Space* place_space = nullptr;
-    for (auto& space : savedSpaces) {
-        if (space.position_id == place_position) {
-            place_space = &space;
-            break;
-        }
-    }
-
-    if (!place_space) {
-        cout << "Error: Could not find space for the specified place position." << endl;
-        return;
-    }
-
-    // Check if place position is empty
-    if (place_space->colour != 0) {
-        cout << "Place position R" << place_space->row << "C" << place_space->col
-            << " is not empty! It contains " << colourNames[place_space->colour] << " block." << endl;
-        return;
-    }
-
-    cout << "Pick from: R" << pick_space->row << "C" << pick_space->col
-        << " (Position " << pick_space->position_id << ")" << endl;
-    cout << "Place to: R" << place_space->row << "C" << place_space->col
-        << " (Position " << place_space->position_id << ")" << endl;
-    cout << "Block colour: " << colourName << endl;
-
-    int pick = pick_space->row;  // Use row number (1-3)
-    int place = place_space->row; // Use row number (1-3)
-    // Use some binary calculation to calculate the value to send
-    unsigned char cmd = (unsigned char)((((pick - 1) << 4) | (place - 1)) + 1);
-
-    cout << "Generated command: pick_row=" << pick << ", place_row=" << place << ", cmd=" << int(cmd) << endl;
-
-    // Send command sequence
-    if (port) {
-        sp_blocking_write(port, &cmd, 1, 100);
-        cout << "Command sent: " << int(cmd) << endl;
-
-        // Wait 2 seconds
-        this_thread::sleep_for(milliseconds(2000));
-
-        // Send zero command
-        cmd = 0;
-        sp_blocking_write(port, &cmd, 1, 100);
-        sp_drain(port);
-
-        cout << "Command reset" << endl;
-    }
-    else {
-        cout << "Serial port not available!" << endl;
-    }
-
-    // Update the board state (simulate movement)
-    place_space->colour = pick_space->colour;
-    pick_space->colour = 0;
-
-    cout << "Movement completed!" << endl;
-
-    // Reset GUI selection
-    selectedColour = 0;
-    selectedRow = 0;
-}
-
-// Executes reset operation (move all blocks from column 3 to column 1)
-void executeReset(struct sp_port* port) {
-    if (!spacesCalibrated || savedSpaces.empty()) {
-        cout << "Matrix not calibrated yet!" << endl;
-        return;
-    }
-
-    // Find blocks in column 3 and empty positions in column 1
-    vector<Space*> blocksInC3 = findBlocksInColumn3();
-    vector<Space*> emptyPositionsInC1 = findEmptyPositionsInColumn1();
-
-    if (blocksInC3.empty()) {
-        cout << "No blocks found in column 3 to reset!" << endl;
-        return;
-    }
-
-    if (emptyPositionsInC1.empty()) {
-        cout << "No empty positions available in column 1!" << endl;
-        return;
-    }
-
-    cout << "Starting reset operation..." << endl;
-    cout << "Found " << blocksInC3.size() << " blocks in column 3" << endl;
-    cout << "Found " << emptyPositionsInC1.size() << " empty positions in column 1" << endl;
-
-    // Move blocks from C3 to C1
-    for (size_t i = 0; i < min(blocksInC3.size(), emptyPositionsInC1.size()); i++) {
-        Space* pick_space = blocksInC3[i];
-        Space* place_space = emptyPositionsInC1[i];
-
-        cout << "Moving block from R" << pick_space->row << "C" << pick_space->col
-            << " to R" << place_space->row << "C" << place_space->col << endl;
-        cout << "Block colour: " << colourNames[pick_space->colour] << endl;
-
-        // Get the command for this specific movement
-        auto cmdIt = resetCmdMap.find({ pick_space->row, place_space->row });
-        if (cmdIt == resetCmdMap.end()) {
-            cout << "Error: No command found for movement from R" << pick_space->row
-                << " to R" << place_space->row << endl;
-            continue;
-        }
-
-        unsigned char cmd = cmdIt->second;
-        cout << "Using command: " << int(cmd) << " for C3R" << pick_space->row
-            << " -> C1R" << place_space->row << endl;
-
-        // Send command sequence
-        if (port) {
-            sp_blocking_write(port, &cmd, 1, 100);
-            cout << "Command sent: " << int(cmd) << endl;
-
-            // Wait for operation to complete
-            this_thread::sleep_for(milliseconds(15000));
-
-            // Send zero command
-            cmd = 0;
-            sp_blocking_write(port, &cmd, 1, 100);
-            sp_drain(port);
-
-            cout << "Command reset" << endl;
-        }
-        else {
-            cout << "Serial port not available!" << endl;
-        }
-
-        // Update the board state (simulate movement)
-        place_space->colour = pick_space->colour;
-        pick_space->colour = 0;
-
-        cout << "Movement " << (i + 1) << " completed!" << endl;
-
-        // Small delay between movements
-        if (i < min(blocksInC3.size(), emptyPositionsInC1.size()) - 1) {
-            this_thread::sleep_for(milliseconds(1000));
-        }
-    }
-
-    cout << "Reset operation completed! Moved "
-        << min(blocksInC3.size(), emptyPositionsInC1.size()) << " blocks from C3 to C1." << endl;
-}
-
-// ===================================================================================
-//                        MAIN FUNCTION
-// ===================================================================================
-
-int main(int argc, char* argv[])
-{
-    if (!global_cap.isOpened()) {
-        cout << "Cannot open camera" << endl;
-        return -1;
-    }
-
-    struct sp_port* port = nullptr;
-    int err;
-
-    // Initialize serial port
-    if (argc >= 2) {
-        err = sp_get_port_by_name("COM3", &port);
-        if (err == SP_OK) {
-            err = sp_open(port, SP_MODE_WRITE);
-            if (err == SP_OK) {
-                sp_set_baudrate(port, BAUD);
-                sp_set_bits(port, 8);
-                cout << "Serial port initialized successfully" << endl;
-            }
-            else {
-                cout << "Warning: Could not open serial port" << endl;
-                port = nullptr;
-            }
-        }
-        else {
-            cout << "Warning: Could not find serial port" << endl;
-            port = nullptr;
-        }
-    }
-    else {
-        cout << "Warning: No serial port specified. Running in simulation mode." << endl;
-    }
-
-    cout << "Robot Control System Started" << endl;
-    cout << "Calibrate matrix to start" << endl;
-
-    // Create control panel window
-    namedWindow("Control Panel", WINDOW_NORMAL);
-    resizeWindow("Control Panel", 400, 600);
-    setMouseCallback("Control Panel", onMouse, port);
-
-    // Create live feed window
-    namedWindow("Live Feed", WINDOW_NORMAL);
-
-    // Ensure cmd = 0 first
-    unsigned char cmd = 0;
-    if (port) {
-        sp_blocking_write(port, &cmd, 1, 100);
-    }
-
-    while (true) {
-        Mat liveFrame;
-        if (global_cap.read(liveFrame)) {
-            if (spacesCalibrated) {
-                if (continuousColourDetection) {
-                    checkSpaceColoursLive(liveFrame);
-                }
-                else {
-                    for (size_t i = 0; i < savedSpaces.size(); i++) {
-                        circle(liveFrame, savedSpaces[i].center, 5, Scalar(0, 255, 0), 2);
-                    }
-                    putText(liveFrame, "Matrix Calibrated - " + to_string(savedSpaces.size()) + " positions",
-                        Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 255, 0), 2);
-                }
-
-                // Display current selection on live feed
-                string colourName = (selectedColour > 0) ? colourNames[selectedColour] : "None";
-                string selectionText = "Selection: " + colourName + " -> Row " + to_string(selectedRow);
-                putText(liveFrame, selectionText, Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.5, Scalar(255, 255, 0), 2);
-            }
-            else {
-                putText(liveFrame, "Calibrate Matrix in Control Panel",
-                    Point(10, 30), FONT_HERSHEY_SIMPLEX, 0.7, Scalar(0, 0, 255), 2);
-            }
-
-            imshow("Live Feed", liveFrame);
-        }
-
-        // Update control panel
-        createControlPanel();
-
-        int key = waitKey(30);
-        
-        // Exit program
-        if (key == 'q' || key == 'Q' || key == 27) {
-            cout << "Quitting..." << endl;
-            if (port) {
-                sp_close(port);
-            }
-            break;
-        }
-    }
-
-    if (port) {
-        sp_close(port);
-    }
-    return 0;
-}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "opencv2/highgui/highgui.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Owns the camera and reads it on a dedicated thread so the driver buffer never backs up.
+// Frames are captured into a ring of three preallocated Mats shared through a single atomic
+// index (triple buffering): the capture thread always has a buffer to write into, the
+// consumer always gets the newest complete frame without copying, and any frame the
+// consumer did not pick up in time is simply overwritten.
+class FrameGrabber {
+public:
+    static const int RING_SIZE = 3;
+
+    ~FrameGrabber() {
+        stop();
+    }
+
+    bool open(int device) {
+        cap.open(device);
+        return configure();
+    }
+
+    bool open(const std::string& source) {
+        cap.open(source);
+        return configure();
+    }
+
+    bool isOpened() const {
+        return cap.isOpened();
+    }
+
+    // Starts the capture thread
+    void start() {
+        if (running || !cap.isOpened()) return;
+        running = true;
+        worker = std::thread(&FrameGrabber::captureLoop, this);
+    }
+
+    // Stops the capture thread and waits for it to finish
+    void stop() {
+        running = false;
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Hands over the newest frame if one arrived since the last call. The returned Mat refers
+    // to a ring buffer owned by the grabber and stays valid until the next acquire call.
+    // capturedAt, if given, receives the time the capture thread finished reading the frame.
+    bool acquireLatest(cv::Mat& frame, std::chrono::steady_clock::time_point* capturedAt = nullptr) {
+        if (!(shared.load(std::memory_order_acquire) & FRESH_FLAG)) return false;
+
+        int previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        handedOver++;
+        frame = ring[readIndex];
+        if (capturedAt) {
+            *capturedAt = stamps[readIndex];
+        }
+        return true;
+    }
+
+    // Waits up to timeoutMs for a frame captured after this call was made
+    bool waitForFrame(cv::Mat& frame, int timeoutMs) {
+        acquireLatest(frame); // Discard whatever is already waiting
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (acquireLatest(frame)) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    unsigned long long framesCaptured() const {
+        return captured.load();
+    }
+
+    unsigned long long framesDropped() const {
+        return dropped.load();
+    }
+
+    // Frames handed to the consumer so far. A Mat from acquireLatest is only safe to use
+    // while this has not changed since it was acquired.
+    unsigned long long framesHandedOver() const {
+        return handedOver;
+    }
+
+private:
+    static const int INDEX_MASK = 0x3;
+    static const int FRESH_FLAG = 0x4;
+
+    bool configure() {
+        if (!cap.isOpened()) return false;
+        // Ask the driver to hold as few frames as possible; not every backend supports this
+        cap.set(cv::CAP_PROP_BUFFERSIZE, 1);
+
+        // Preallocate the ring at the reported frame size so reads never allocate
+        int width = (int)cap.get(cv::CAP_PROP_FRAME_WIDTH);
+        int height = (int)cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+        if (width > 0 && height > 0) {
+            for (int i = 0; i < RING_SIZE; i++) {
+                ring[i].create(height, width, CV_8UC3);
+            }
+        }
+        return true;
+    }
+
+    void captureLoop() {
+        while (running) {
+            if (!cap.read(ring[writeIndex])) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+            stamps[writeIndex] = std::chrono::steady_clock::now();
+            captured++;
+
+            // Publish the finished buffer and take back whichever one was waiting
+            int previous = shared.exchange(writeIndex | FRESH_FLAG, std::memory_order_acq_rel);
+            if (previous & FRESH_FLAG) {
+                dropped++;
+            }
+            writeIndex = previous & INDEX_MASK;
+        }
+    }
+
+    cv::VideoCapture cap;
+    std::thread worker;
+    std::atomic<bool> running{ false };
+
+    cv::Mat ring[RING_SIZE];
+    std::chrono::steady_clock::time_point stamps[RING_SIZE]; // Capture time of each buffer
+    std::atomic<int> shared{ 1 }; // Buffer waiting between the threads, plus FRESH_FLAG
+    int writeIndex = 0;           // Only touched by the capture thread
+    int readIndex = 2;            // Only touched by the consumer
+    unsigned long long handedOver = 0; // Only touched by the consumer
+
+    std::atomic<unsigned long long> captured{ 0 };
+    std::atomic<unsigned long long> dropped{ 0 };
+};
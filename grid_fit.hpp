@@ -0,0 +1,191 @@
+#pragma once
+
+#include "opencv2/core/core.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Fits detected space centres to a rows x cols lattice. Each axis is clustered separately
+// (1-D k-means seeded from quantiles), a straight line through the cluster centres gives the
+// lattice pitch and offset, and every point is snapped to its nearest lattice cell. Points far
+// from any cell, or losing a cell to a closer point, are outliers; cells nobody claimed are
+// reported as missing with their lattice position so the caller can fill them in.
+// Lattices that cannot be the board are rejected: neighbouring rows or columns much closer
+// than a pitch (one row of spaces split into several), or a pitch far from the expected one.
+// Works best on top-down (rectified) coordinates, where rows and columns are straight.
+struct GridFit {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> rowOf;           // Per input point: 0-based row, or -1 for an outlier
+    std::vector<int> colOf;           // Per input point: 0-based column from the left, or -1
+    std::vector<cv::Point2f> missing; // Lattice position of every cell without a point
+    std::vector<cv::Point> missingCells; // (column, row) of each missing cell, 0-based
+    int outliers = 0;
+    double pitchX = 0;
+    double pitchY = 0;
+};
+
+namespace grid_fit_detail {
+    const double MIN_SEPARATION = 0.5;  // Closest neighbouring rows/columns, as a fraction of the pitch
+    const double PITCH_TOLERANCE = 0.5; // Largest pitch error, as a fraction of the expected pitch
+
+    // 1-D k-means; returns the sorted cluster centres, or an empty vector with too few values
+    inline std::vector<double> cluster(std::vector<double> values, int k) {
+        std::sort(values.begin(), values.end());
+        if (k <= 0 || (int)values.size() < k) return std::vector<double>();
+
+        std::vector<double> centres(k);
+        for (int c = 0; c < k; c++) {
+            centres[c] = values[(size_t)((c + 0.5) * values.size() / k)];
+        }
+
+        std::vector<int> owner(values.size(), -1);
+        for (int iteration = 0; iteration < 20; iteration++) {
+            bool changed = false;
+            for (size_t i = 0; i < values.size(); i++) {
+                int best = 0;
+                for (int c = 1; c < k; c++) {
+                    if (std::fabs(values[i] - centres[c]) < std::fabs(values[i] - centres[best])) best = c;
+                }
+                if (owner[i] != best) {
+                    owner[i] = best;
+                    changed = true;
+                }
+            }
+            if (!changed) break;
+
+            std::vector<double> sum(k, 0);
+            std::vector<int> count(k, 0);
+            for (size_t i = 0; i < values.size(); i++) {
+                sum[owner[i]] += values[i];
+                count[owner[i]]++;
+            }
+            for (int c = 0; c < k; c++) {
+                if (count[c] > 0) centres[c] = sum[c] / count[c];
+            }
+        }
+        std::sort(centres.begin(), centres.end());
+        return centres;
+    }
+
+    // Least-squares line through the cluster centres: position = offset + pitch * index
+    inline bool fitLine(const std::vector<double>& centres, double& offset, double& pitch) {
+        int n = (int)centres.size();
+        if (n == 1) {
+            offset = centres[0];
+            pitch = 0;
+            return true;
+        }
+        double meanIndex = (n - 1) / 2.0, meanValue = 0;
+        for (double centre : centres) meanValue += centre / n;
+        double covariance = 0, variance = 0;
+        for (int i = 0; i < n; i++) {
+            covariance += (i - meanIndex) * (centres[i] - meanValue);
+            variance += (i - meanIndex) * (i - meanIndex);
+        }
+        pitch = covariance / variance;
+        offset = meanValue - pitch * meanIndex;
+        return pitch > 0;
+    }
+
+    // Checks one axis of a fit. 'expected' is the expected pitch, or 0 if unknown, in which
+    // case neighbours are compared with 'fallback' (the larger pitch of the two axes)
+    inline bool plausibleAxis(const std::vector<double>& centres, double pitch, double expected, double fallback) {
+        if (centres.size() < 2) return true; // A single row or column has no pitch of its own
+        if (expected > 0 && std::fabs(pitch - expected) > PITCH_TOLERANCE * expected) return false;
+        double reference = expected > 0 ? expected : fallback;
+        for (size_t i = 1; i < centres.size(); i++) {
+            if (centres[i] - centres[i - 1] < MIN_SEPARATION * reference) return false;
+        }
+        return true;
+    }
+
+    inline int nearestIndex(double value, double offset, double pitch, int count) {
+        if (pitch <= 0) return 0;
+        int index = (int)std::lround((value - offset) / pitch);
+        return std::min(std::max(index, 0), count - 1);
+    }
+}
+
+// Fits 'points' to the lattice; returns false when there are too few points to find it or the
+// lattice found is not plausible. expectedPitch (width for columns, height for rows) is the
+// spacing the board should have, or 0 when it is not known.
+// 'tolerance' is the largest distance from a cell centre, as a fraction of the pitch.
+inline bool fitGrid(const std::vector<cv::Point2f>& points, int rows, int cols, GridFit& fit,
+    const cv::Size2d& expectedPitch = cv::Size2d(), double tolerance = 0.35) {
+    fit = GridFit();
+    fit.rows = rows;
+    fit.cols = cols;
+    if (rows <= 0 || cols <= 0 || (int)points.size() < std::max(rows, cols)) return false;
+
+    // Two passes: the second clusters without the outliers found by the first
+    std::vector<bool> inlier(points.size(), true);
+    double offsetX = 0, offsetY = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<double> xs, ys;
+        for (size_t i = 0; i < points.size(); i++) {
+            if (!inlier[i]) continue;
+            xs.push_back(points[i].x);
+            ys.push_back(points[i].y);
+        }
+        std::vector<double> colCentres = grid_fit_detail::cluster(xs, cols);
+        std::vector<double> rowCentres = grid_fit_detail::cluster(ys, rows);
+        if (colCentres.empty() || rowCentres.empty() ||
+            !grid_fit_detail::fitLine(colCentres, offsetX, fit.pitchX) ||
+            !grid_fit_detail::fitLine(rowCentres, offsetY, fit.pitchY)) {
+            return false;
+        }
+        double largerPitch = std::max(fit.pitchX, fit.pitchY);
+        if (!grid_fit_detail::plausibleAxis(colCentres, fit.pitchX, expectedPitch.width, largerPitch) ||
+            !grid_fit_detail::plausibleAxis(rowCentres, fit.pitchY, expectedPitch.height, largerPitch)) {
+            return false;
+        }
+
+        // A single row or column has no pitch of its own; borrow the other axis
+        if (fit.pitchX == 0) fit.pitchX = fit.pitchY;
+        if (fit.pitchY == 0) fit.pitchY = fit.pitchX;
+        if (fit.pitchX <= 0) return false;
+
+        for (size_t i = 0; i < points.size(); i++) {
+            int col = grid_fit_detail::nearestIndex(points[i].x, offsetX, fit.pitchX, cols);
+            int row = grid_fit_detail::nearestIndex(points[i].y, offsetY, fit.pitchY, rows);
+            double dx = (points[i].x - (offsetX + fit.pitchX * col)) / fit.pitchX;
+            double dy = (points[i].y - (offsetY + fit.pitchY * row)) / fit.pitchY;
+            inlier[i] = std::sqrt(dx * dx + dy * dy) <= tolerance;
+        }
+    }
+
+    // Snap inliers to cells; when two points claim a cell the closer one keeps it
+    std::vector<int> owner(rows * cols, -1);
+    std::vector<double> ownerDistance(rows * cols, 0);
+    fit.rowOf.assign(points.size(), -1);
+    fit.colOf.assign(points.size(), -1);
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!inlier[i]) continue;
+        int col = grid_fit_detail::nearestIndex(points[i].x, offsetX, fit.pitchX, cols);
+        int row = grid_fit_detail::nearestIndex(points[i].y, offsetY, fit.pitchY, rows);
+        double distance = std::hypot(points[i].x - (offsetX + fit.pitchX * col), points[i].y - (offsetY + fit.pitchY * row));
+        int cell = row * cols + col;
+        if (owner[cell] >= 0 && ownerDistance[cell] <= distance) continue;
+        if (owner[cell] >= 0) {
+            fit.rowOf[owner[cell]] = -1;
+            fit.colOf[owner[cell]] = -1;
+        }
+        owner[cell] = (int)i;
+        ownerDistance[cell] = distance;
+        fit.rowOf[i] = row;
+        fit.colOf[i] = col;
+    }
+
+    for (size_t i = 0; i < points.size(); i++) {
+        if (fit.rowOf[i] < 0) fit.outliers++;
+    }
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (owner[row * cols + col] >= 0) continue;
+            fit.missing.push_back(cv::Point2f((float)(offsetX + fit.pitchX * col), (float)(offsetY + fit.pitchY * row)));
+            fit.missingCells.push_back(cv::Point(col, row));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+// Lets one loop run several jobs at their own rates. Each job keeps a Cadence and asks it
+// whether it is due; a rate of 0 means "every time it is asked". Missed slots are not made up
+// in a burst: a job that fell behind runs once and then resumes its normal period.
+class Cadence {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit Cadence(double hz = 0) {
+        setRate(hz);
+    }
+
+    void setRate(double hz) {
+        period = hz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz))
+            : Clock::duration::zero();
+        next = Clock::time_point();
+    }
+
+    double rate() const {
+        return period.count() > 0 ? 1.0 / std::chrono::duration<double>(period).count() : 0;
+    }
+
+    // True once the next slot has started
+    bool ready(Clock::time_point now) const {
+        return now >= next;
+    }
+
+    // Marks the current slot as used
+    void consume(Clock::time_point now) {
+        next += period;
+        if (next <= now) next = now + period;
+    }
+
+    // ready() and consume() in one step, for jobs that always run when due
+    bool due(Clock::time_point now) {
+        if (!ready(now)) return false;
+        consume(now);
+        return true;
+    }
+
+    Clock::time_point nextDue() const {
+        return next;
+    }
+
+private:
+    Clock::duration period;
+    Clock::time_point next;
+};
+
+// Parses a rate in Hz for a command line option; accepts 0 (unthrottled) and positive values
+inline bool parseRate(const std::string& text, double& hz) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || value < 0) return false;
+    hz = value;
+    return true;
+}
@@ -0,0 +1,646 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A board space as the planner sees it
+struct GridCell {
+    int position_id;
+    int row;
+    int col;
+};
+
+// Estimates how long the arm takes for one pick/place. A move is the approach from wherever
+// the arm is to the pick space, plus the carry (grip, travel, release) to the place space.
+// Travel is linear in the row and column distance; carries that have actually been timed
+// replace the estimate once observe() has seen them.
+class MoveCostModel {
+public:
+    double handlingMs = 3000;  // Gripping and releasing one block
+    double msPerRow = 500;
+    double msPerColumn = 700;
+    double settleMs = 1000;    // Pause the host inserts between separate commands
+    double homeRow = 2;        // Where the arm waits between plans, in grid coordinates
+    double homeCol = 2;
+
+    double travelMs(double fromRow, double fromCol, double toRow, double toCol) const {
+        return msPerRow * std::fabs(toRow - fromRow) + msPerColumn * std::fabs(toCol - fromCol);
+    }
+
+    double carryMs(const GridCell& pick, const GridCell& place) const {
+        auto it = measured.find({ pick.position_id, place.position_id });
+        if (it != measured.end()) return it->second;
+        return handlingMs + travelMs(pick.row, pick.col, place.row, place.col);
+    }
+
+    // Time for one move with the arm starting at (armRow, armCol)
+    double moveMs(const GridCell& pick, const GridCell& place, double armRow, double armCol) const {
+        return travelMs(armRow, armCol, pick.row, pick.col) + carryMs(pick, place);
+    }
+
+    // Folds the measured duration of a move that started at (armRow, armCol) into the carry estimate
+    void observe(const GridCell& pick, const GridCell& place, double armRow, double armCol, double elapsedMs) {
+        double carry = elapsedMs - travelMs(armRow, armCol, pick.row, pick.col);
+        if (carry <= 0) return;
+        auto key = std::make_pair(pick.position_id, place.position_id);
+        auto it = measured.find(key);
+        if (it == measured.end()) {
+            measured[key] = carry;
+        }
+        else {
+            it->second = 0.7 * it->second + 0.3 * carry;
+        }
+        revisionCount++;
+    }
+
+    // Changes every time observe() refines an estimate, so cached plans can tell they are stale
+    unsigned long revision() const {
+        return revisionCount;
+    }
+
+private:
+    std::map<std::pair<int, int>, double> measured; // (pick, place) position_id -> carry ms
+    unsigned long revisionCount = 0;
+};
+
+struct PlannedMove {
+    GridCell pick;
+    GridCell place;
+    double estimatedMs;
+    int colour = 0; // Colour of the block being moved, when known
+};
+
+struct MovePlan {
+    std::vector<PlannedMove> moves;
+    double totalMs = 0;
+    bool optimal = true; // False when the search was too large and a greedy plan was used
+};
+
+namespace planner_detail {
+    struct TransferSearch {
+        TransferSearch(const std::vector<GridCell>& blocks, const std::vector<GridCell>& spaces,
+            const MoveCostModel& model, bool separateCommands, size_t moveCount)
+            : blocks(blocks), spaces(spaces), model(model), separateCommands(separateCommands), moveCount(moveCount),
+            blockUsed(blocks.size(), false), spaceUsed(spaces.size(), false) {
+            best.totalMs = std::numeric_limits<double>::infinity();
+        }
+
+        const std::vector<GridCell>& blocks;
+        const std::vector<GridCell>& spaces;
+        const MoveCostModel& model;
+        bool separateCommands;
+        size_t moveCount;
+        std::vector<bool> blockUsed;
+        std::vector<bool> spaceUsed;
+        std::vector<PlannedMove> current;
+        MovePlan best;
+
+        void search(double armRow, double armCol, double elapsed) {
+            if (elapsed >= best.totalMs) return; // Cannot beat the best plan found so far
+            if (current.size() == moveCount) {
+                best.moves = current;
+                best.totalMs = elapsed;
+                return;
+            }
+
+            double settle = (!current.empty() && separateCommands) ? model.settleMs : 0;
+            for (size_t b = 0; b < blocks.size(); b++) {
+                if (blockUsed[b]) continue;
+                blockUsed[b] = true;
+                for (size_t s = 0; s < spaces.size(); s++) {
+                    if (spaceUsed[s]) continue;
+                    double ms = settle + model.moveMs(blocks[b], spaces[s], armRow, armCol);
+                    spaceUsed[s] = true;
+                    current.push_back(PlannedMove{ blocks[b], spaces[s], ms });
+                    search(spaces[s].row, spaces[s].col, elapsed + ms);
+                    current.pop_back();
+                    spaceUsed[s] = false;
+                }
+                blockUsed[b] = false;
+            }
+        }
+    };
+
+    // Number of complete (block, space) move sequences the exhaustive search can visit,
+    // saturating at 'cap' so large boards do not overflow
+    inline double transferOrderings(size_t blocks, size_t spaces, size_t moveCount, double cap) {
+        double orderings = 1;
+        for (size_t m = 0; m < moveCount && orderings <= cap; m++) {
+            orderings *= (double)(blocks - m) * (double)(spaces - m);
+        }
+        return orderings;
+    }
+}
+
+// Chooses which blocks go to which free spaces, and in what order, so that the estimated
+// total time is as short as possible. Moves as many blocks as there are free spaces.
+// Searches every assignment and order (branch and bound) while the number of possible move
+// sequences is at most searchLimit, which keeps the exhaustive search bounded however tall or
+// wide the board is; larger problems fall back to repeatedly taking the cheapest next move.
+// separateCommands adds the model's settle time between moves, as when each move is its
+// own legacy command.
+inline MovePlan planTransfers(const std::vector<GridCell>& blocks, const std::vector<GridCell>& spaces,
+    const MoveCostModel& model, bool separateCommands, double searchLimit = 200000) {
+    size_t moveCount = std::min(blocks.size(), spaces.size());
+
+    if (planner_detail::transferOrderings(blocks.size(), spaces.size(), moveCount, searchLimit) <= searchLimit) {
+        planner_detail::TransferSearch search(blocks, spaces, model, separateCommands, moveCount);
+        search.search(model.homeRow, model.homeCol, 0);
+        return search.best;
+    }
+
+    MovePlan plan;
+    plan.optimal = false;
+    std::vector<bool> blockUsed(blocks.size(), false), spaceUsed(spaces.size(), false);
+    double armRow = model.homeRow, armCol = model.homeCol;
+    for (size_t m = 0; m < moveCount; m++) {
+        double settle = (m > 0 && separateCommands) ? model.settleMs : 0;
+        size_t bestBlock = 0, bestSpace = 0;
+        double bestMs = std::numeric_limits<double>::infinity();
+        for (size_t b = 0; b < blocks.size(); b++) {
+            if (blockUsed[b]) continue;
+            for (size_t s = 0; s < spaces.size(); s++) {
+                if (spaceUsed[s]) continue;
+                double ms = model.moveMs(blocks[b], spaces[s], armRow, armCol);
+                if (ms < bestMs) {
+                    bestMs = ms;
+                    bestBlock = b;
+                    bestSpace = s;
+                }
+            }
+        }
+        blockUsed[bestBlock] = spaceUsed[bestSpace] = true;
+        plan.moves.push_back(PlannedMove{ blocks[bestBlock], spaces[bestSpace], settle + bestMs });
+        plan.totalMs += settle + bestMs;
+        armRow = spaces[bestSpace].row;
+        armCol = spaces[bestSpace].col;
+    }
+    return plan;
+}
+
+// Colour of every cell of a board, in the same order as the cells passed to the planner
+typedef std::vector<int> BoardLayout;
+
+// Target cells that may hold anything
+const int LAYOUT_ANY = -1;
+
+namespace planner_detail {
+    // A board packed two bits per cell (colours 0-3), so a search state is a few machine words
+    // and comparing or hashing one never allocates
+    struct PackedBoard {
+        static const size_t MAX_CELLS = 256;
+        std::array<uint64_t, MAX_CELLS / 32> words{};
+
+        int get(size_t cell) const {
+            return (int)((words[cell / 32] >> (cell % 32 * 2)) & 3);
+        }
+
+        void set(size_t cell, int colour) {
+            uint64_t& word = words[cell / 32];
+            word = (word & ~(uint64_t(3) << (cell % 32 * 2))) | (uint64_t(colour) << (cell % 32 * 2));
+        }
+
+        bool operator==(const PackedBoard& other) const {
+            return words == other.words;
+        }
+    };
+
+    // A search state: the board and the cell the arm finished over (-1 for home), since the
+    // cost of the next move depends on both
+    struct SearchState {
+        PackedBoard board;
+        int arm;
+
+        bool operator==(const SearchState& other) const {
+            return arm == other.arm && board == other.board;
+        }
+    };
+
+    struct SearchStateHash {
+        size_t operator()(const SearchState& state) const {
+            uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)(state.arm + 1);
+            for (uint64_t word : state.board.words) {
+                hash = (hash ^ word) * 0x100000001b3ULL;
+                hash ^= hash >> 29;
+            }
+            return (size_t)hash;
+        }
+    };
+}
+
+// Plans a short sequence of pick/place moves that turns one board layout into another.
+// Blocks of the same colour are interchangeable and blocks that are in the way are moved to a
+// free cell first, so any reachable arrangement can be requested in one go. The search is A*
+// over (packed board layout, arm position) states on the estimated time from the cost model.
+// The heuristic is the cheapest single carry for every misplaced block plus the settle pauses
+// between them and the shortest approach, which never overestimates. When any move is allowed,
+// blocks already in place stay put and the others only go to cells that accept them, or park
+// on any free cell when none does, so the plan is the fastest among those moves.
+//
+// Half of the budget (maxExpansions states or timeBudget) goes to that search; if it runs out,
+// a weighted search trades optimality for speed with the rest and the plan is marked as not
+// optimal. Plans are cached per start/target pair and cost model revision, since the same
+// arrangements tend to be requested over and over.
+class LayoutPlanner {
+public:
+    size_t maxExpansions = 200000;              // Search budget before giving up
+    std::chrono::milliseconds timeBudget{ 500 };
+    double fallbackWeight = 4;                  // Heuristic weight once the optimal search ran out
+    size_t cacheSize = 64;
+
+    // Finds a plan; on failure returns false with the reason in 'error'. With legacyMovesOnly
+    // set, only the moves the single-byte protocol can express are used (column 1 to column 3
+    // and back).
+    bool plan(const std::vector<GridCell>& cells, const BoardLayout& current, const BoardLayout& target,
+        const MoveCostModel& model, bool separateCommands, bool legacyMovesOnly, MovePlan& result, std::string& error) {
+        if (current.size() != cells.size() || target.size() != cells.size()) {
+            error = "Layout does not match the board size";
+            return false;
+        }
+        if (cells.size() > planner_detail::PackedBoard::MAX_CELLS) {
+            error = "Board has too many cells to plan";
+            return false;
+        }
+        if (!feasible(current, target, error)) return false;
+
+        std::string key = encode(current) + "|" + encode(target) +
+            (separateCommands ? "s" : "f") + (legacyMovesOnly ? "l" : "a") + "|" + encode(model);
+        auto cached = cache.find(key);
+        if (cached != cache.end()) {
+            cacheHits++;
+            result = cached->second;
+            return true;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        lastExpansions = 0;
+        if (!search(cells, current, target, model, separateCommands, legacyMovesOnly, 1.0,
+            maxExpansions / 2, started + timeBudget / 2, result, error)) {
+            if (error != BUDGET_EXHAUSTED) return false;
+            if (!search(cells, current, target, model, separateCommands, legacyMovesOnly, fallbackWeight,
+                maxExpansions - lastExpansions, started + timeBudget, result, error)) {
+                return false;
+            }
+            result.optimal = false;
+            error.clear();
+        }
+
+        cache[key] = result;
+        cacheOrder.push_back(key);
+        if (cacheOrder.size() > cacheSize) {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+        return true;
+    }
+
+    void clearCache() {
+        cache.clear();
+        cacheOrder.clear();
+    }
+
+    unsigned long cacheHits = 0;
+    size_t lastExpansions = 0; // States expanded by the most recent plan() that searched
+
+private:
+    static constexpr const char* BUDGET_EXHAUSTED = "Search budget exhausted";
+
+    struct Visit {
+        planner_detail::SearchState state; // Board and the cell the arm finished over, -1 for home
+        double ms;
+        int moves;
+        size_t parent;  // Index into the visit list
+        PlannedMove move;
+    };
+
+    // One character per cell (colour + '0', or '*' for LAYOUT_ANY)
+    static std::string encode(const BoardLayout& layout) {
+        std::string text(layout.size(), '0');
+        for (size_t i = 0; i < layout.size(); i++) {
+            text[i] = layout[i] == LAYOUT_ANY ? '*' : (char)('0' + layout[i]);
+        }
+        return text;
+    }
+
+    // The model settings and revision a plan was made with
+    static std::string encode(const MoveCostModel& model) {
+        return std::to_string(model.handlingMs) + "," + std::to_string(model.msPerRow) + "," +
+            std::to_string(model.msPerColumn) + "," + std::to_string(model.settleMs) + "," +
+            std::to_string(model.homeRow) + "," + std::to_string(model.homeCol) + "," +
+            std::to_string(model.revision());
+    }
+
+    static bool feasible(const BoardLayout& current, const BoardLayout& target, std::string& error) {
+        std::map<int, int> have, want;
+        int anyCells = 0;
+        for (int colour : current) {
+            if (colour < 0) {
+                error = "Board has cells with an uncertain colour";
+                return false;
+            }
+            if (colour > 3) {
+                error = "Board has cells with an unknown colour";
+                return false;
+            }
+            if (colour > 0) have[colour]++;
+        }
+        for (int colour : target) {
+            if (colour == LAYOUT_ANY) anyCells++;
+            else if (colour > 3) {
+                error = "Target has cells with an unknown colour";
+                return false;
+            }
+            else if (colour > 0) want[colour]++;
+        }
+
+        int spare = 0;
+        for (const auto& entry : want) {
+            if (have[entry.first] < entry.second) {
+                error = "Not enough blocks of colour " + std::to_string(entry.first);
+                return false;
+            }
+        }
+        for (const auto& entry : have) {
+            spare += entry.second - want[entry.first];
+        }
+        if (spare > anyCells) {
+            error = "Target has no room for every block on the board";
+            return false;
+        }
+        return true;
+    }
+
+    // A* with the heuristic scaled by 'weight' (1 = optimal); adds its expansions to lastExpansions
+    bool search(const std::vector<GridCell>& cells, const BoardLayout& current, const BoardLayout& target,
+        const MoveCostModel& model, bool separateCommands, bool legacyMovesOnly, double weight, size_t expansionBudget,
+        std::chrono::steady_clock::time_point deadline, MovePlan& result, std::string& error) {
+        using planner_detail::PackedBoard;
+        using planner_detail::SearchState;
+        const double INF = std::numeric_limits<double>::infinity();
+        size_t n = cells.size();
+
+        // Carry times and allowed moves are the same for every state, so work them out once
+        std::vector<double> carry(n * n, INF);
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = 0; q < n; q++) {
+                if (p == q) continue;
+                if (legacyMovesOnly && !((cells[p].col == 1 && cells[q].col == 3) ||
+                    (cells[p].col == 3 && cells[q].col == 1))) continue;
+                carry[p * n + q] = model.carryMs(cells[p], cells[q]);
+            }
+        }
+
+        // Cheapest first carry for a block of each colour that is not where the target wants it:
+        // straight into a cell that accepts it if possible, otherwise anywhere it is allowed to go
+        std::vector<double> firstCarry(n * 4, INF);
+        for (size_t p = 0; p < n; p++) {
+            for (int colour = 1; colour <= 3; colour++) {
+                double direct = INF, any = INF;
+                for (size_t q = 0; q < n; q++) {
+                    any = std::min(any, carry[p * n + q]);
+                    if (target[q] == LAYOUT_ANY || target[q] == colour) direct = std::min(direct, carry[p * n + q]);
+                }
+                firstCarry[p * 4 + colour] = direct < INF ? direct : any;
+            }
+        }
+
+        // Lower bound on the time still needed from a board with the arm over 'arm'
+        auto remaining = [&](const PackedBoard& board, int arm, int movesSoFar) {
+            double bound = 0, approach = INF;
+            int misplaced = 0;
+            for (size_t p = 0; p < n; p++) {
+                int colour = board.get(p);
+                if (colour == 0 || target[p] == LAYOUT_ANY || target[p] == colour) continue;
+                misplaced++;
+                bound += firstCarry[p * 4 + colour];
+                double armRow = arm < 0 ? model.homeRow : cells[arm].row;
+                double armCol = arm < 0 ? model.homeCol : cells[arm].col;
+                approach = std::min(approach, model.travelMs(armRow, armCol, cells[p].row, cells[p].col));
+            }
+            if (misplaced == 0) return 0.0;
+            if (separateCommands) bound += model.settleMs * (movesSoFar > 0 ? misplaced : misplaced - 1);
+            return bound + approach;
+        };
+
+        auto reached = [&](const PackedBoard& board) {
+            for (size_t i = 0; i < n; i++) {
+                if (target[i] != LAYOUT_ANY && board.get(i) != target[i]) return false;
+            }
+            return true;
+        };
+
+        PackedBoard start;
+        for (size_t i = 0; i < n; i++) start.set(i, current[i]);
+
+        std::vector<Visit> visits;
+        std::unordered_map<SearchState, size_t, planner_detail::SearchStateHash> best;
+        typedef std::pair<double, size_t> Entry; // (estimated total, visit index)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+        visits.push_back(Visit{ SearchState{ start, -1 }, 0, 0, 0, PlannedMove() });
+        best[visits[0].state] = 0;
+        open.push(Entry(weight * remaining(start, -1, 0), 0));
+
+        size_t expanded = 0;
+        while (!open.empty()) {
+            size_t index = open.top().second;
+            open.pop();
+            if (best[visits[index].state] != index) continue; // Superseded by a cheaper path
+
+            if (reached(visits[index].state.board)) {
+                result = MovePlan();
+                result.totalMs = visits[index].ms;
+                for (size_t at = index; at != 0; at = visits[at].parent) {
+                    result.moves.push_back(visits[at].move);
+                }
+                std::reverse(result.moves.begin(), result.moves.end());
+                return true;
+            }
+            lastExpansions++;
+            if (++expanded > expansionBudget ||
+                (expanded % 256 == 0 && std::chrono::steady_clock::now() > deadline)) {
+                error = BUDGET_EXHAUSTED;
+                return false;
+            }
+
+            const Visit from = visits[index];
+            const PackedBoard& board = from.state.board;
+            double armRow = from.state.arm < 0 ? model.homeRow : cells[from.state.arm].row;
+            double armCol = from.state.arm < 0 ? model.homeCol : cells[from.state.arm].col;
+            double settle = (from.moves > 0 && separateCommands) ? model.settleMs : 0;
+
+            for (size_t p = 0; p < n; p++) {
+                int colour = board.get(p);
+                if (colour == 0) continue;
+
+                // With free moves, decide which cells this block may usefully go to
+                bool parking = false;
+                if (!legacyMovesOnly) {
+                    if (target[p] == colour) continue;
+                    if (target[p] != LAYOUT_ANY) {
+                        parking = true;
+                        for (size_t q = 0; q < n && parking; q++) {
+                            if (board.get(q) == 0 && (target[q] == LAYOUT_ANY || target[q] == colour)) parking = false;
+                        }
+                    }
+                }
+
+                double approach = model.travelMs(armRow, armCol, cells[p].row, cells[p].col);
+                for (size_t q = 0; q < n; q++) {
+                    if (board.get(q) != 0 || carry[p * n + q] == INF) continue;
+                    if (!legacyMovesOnly && !parking) {
+                        // Blocks on don't-care cells only move to fill a cell that wants them
+                        bool accepts = target[q] == colour || (target[q] == LAYOUT_ANY && target[p] != LAYOUT_ANY);
+                        if (!accepts) continue;
+                    }
+
+                    SearchState next = { board, (int)q };
+                    next.board.set(q, colour);
+                    next.board.set(p, 0);
+                    double ms = settle + approach + carry[p * n + q];
+                    double total = from.ms + ms;
+
+                    auto found = best.find(next);
+                    if (found != best.end() && visits[found->second].ms <= total) continue;
+                    PlannedMove move = { cells[p], cells[q], ms, colour };
+                    visits.push_back(Visit{ next, total, from.moves + 1, index, move });
+                    best[next] = visits.size() - 1;
+                    open.push(Entry(total + weight * remaining(next.board, (int)q, from.moves + 1), visits.size() - 1));
+                }
+            }
+        }
+
+        error = "Target layout cannot be reached with the allowed moves";
+        return false;
+    }
+
+    std::map<std::string, MovePlan> cache;
+    std::deque<std::string> cacheOrder;
+};
+
+// Runs a LayoutPlanner on its own thread, so a long search never holds up the vision and
+// command loop. One request is planned at a time; its callback is queued and run on whichever
+// thread calls dispatchCompletions(), as with RobotCommandQueue.
+class BackgroundLayoutPlanner {
+public:
+    typedef std::function<void(bool ok, const MovePlan& plan, const std::string& error)> Callback;
+
+    LayoutPlanner planner; // Settings may be changed before start()
+
+    ~BackgroundLayoutPlanner() {
+        stop();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        running = true;
+        worker = std::thread(&BackgroundLayoutPlanner::workerLoop, this);
+    }
+
+    // Stops the worker after the search in progress; its callback is dropped
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Queues a search; returns false while another one is still pending. The model is copied,
+    // so the caller may keep refining it while the search runs.
+    bool submit(const std::vector<GridCell>& cells, const BoardLayout& current, const BoardLayout& target,
+        const MoveCostModel& model, bool separateCommands, bool legacyMovesOnly, Callback onDone) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || hasRequest || planning) return false;
+        request = Request{ cells, current, target, model, separateCommands, legacyMovesOnly, onDone };
+        hasRequest = true;
+        wake.notify_all();
+        return true;
+    }
+
+    // True while a search is queued, running, or finished but not yet dispatched
+    bool busy() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hasRequest || planning || !completed.empty();
+    }
+
+    // Runs the callbacks of finished searches on the calling thread
+    void dispatchCompletions() {
+        std::deque<Completion> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.swap(completed);
+        }
+        for (auto& done : ready) {
+            done.onDone(done.ok, done.plan, done.error);
+        }
+    }
+
+private:
+    struct Request {
+        std::vector<GridCell> cells;
+        BoardLayout current;
+        BoardLayout target;
+        MoveCostModel model;
+        bool separateCommands;
+        bool legacyMovesOnly;
+        Callback onDone;
+    };
+
+    struct Completion {
+        bool ok;
+        MovePlan plan;
+        std::string error;
+        Callback onDone;
+    };
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return !running || hasRequest; });
+            if (!running) break;
+
+            Request job = std::move(request);
+            hasRequest = false;
+            planning = true;
+            lock.unlock();
+
+            Completion done = { false, MovePlan(), std::string(), job.onDone };
+            done.ok = planner.plan(job.cells, job.current, job.target, job.model,
+                job.separateCommands, job.legacyMovesOnly, done.plan, done.error);
+
+            lock.lock();
+            planning = false;
+            if (done.onDone) completed.push_back(std::move(done));
+        }
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+    bool running = false;
+    bool hasRequest = false;
+    bool planning = false;
+    Request request;
+    std::deque<Completion> completed;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "robot_queue.hpp"
+#include <chrono>
+#include <vector>
+
+enum VerifyState {
+    VERIFY_IDLE,
+    VERIFY_PENDING,
+    VERIFY_CONFIRMED,
+    VERIFY_MISMATCH
+};
+
+// A space that did not show its expected colour when verification gave up
+struct SpaceMismatch {
+    int position_id;
+    int expected;
+    int observed;
+};
+
+// Watches the live board readings after a robot command and decides when it has really
+// finished: every expected space must show its expected colour for requiredFrames frames
+// in a row. If that has not happened by the deadline (the command's worst-case duration,
+// cut down to ackGrace once the controller acknowledges) the move is reported as a mismatch.
+class MoveVerifier {
+public:
+    int requiredFrames = 5;
+    std::chrono::milliseconds ackGrace{ 1500 };
+
+    // Starts watching for the expected state of a new command
+    void begin(unsigned long commandId, const std::vector<ExpectedSpace>& expectedSpaces,
+        std::chrono::milliseconds timeout) {
+        command = commandId;
+        expected = expectedSpaces;
+        deadline = std::chrono::steady_clock::now() + timeout;
+        acknowledged = false;
+        streak = 0;
+        mismatches.clear();
+        currentState = VERIFY_PENDING;
+    }
+
+    void reset() {
+        command = 0;
+        expected.clear();
+        mismatches.clear();
+        currentState = VERIFY_IDLE;
+    }
+
+    unsigned long activeCommand() const {
+        return command;
+    }
+
+    VerifyState state() const {
+        return currentState;
+    }
+
+    // Spaces that were wrong on the last frame before a mismatch was declared
+    const std::vector<SpaceMismatch>& mismatchReport() const {
+        return mismatches;
+    }
+
+    // Checks one frame of readings. SpaceList is any container of objects with
+    // position_id and colour members (e.g. vector<Space>).
+    template<typename SpaceList>
+    VerifyState update(const SpaceList& spaces, bool commandAcknowledged) {
+        if (currentState != VERIFY_PENDING) return currentState;
+
+        auto now = std::chrono::steady_clock::now();
+        if (commandAcknowledged && !acknowledged) {
+            // The arm says it is done; the board only gets a short grace period to agree
+            acknowledged = true;
+            if (now + ackGrace < deadline) {
+                deadline = now + ackGrace;
+            }
+        }
+
+        // Index the readings by position once, so larger boards stay linear in the space count
+        observedByPosition.clear();
+        for (const auto& space : spaces) {
+            if (space.position_id < 0) continue;
+            if ((size_t)space.position_id >= observedByPosition.size()) {
+                observedByPosition.resize(space.position_id + 1, -1);
+            }
+            observedByPosition[space.position_id] = space.colour;
+        }
+
+        std::vector<SpaceMismatch> wrong;
+        for (const ExpectedSpace& want : expected) {
+            int observed = (want.position_id >= 0 && (size_t)want.position_id < observedByPosition.size())
+                ? observedByPosition[want.position_id] : -1;
+            if (observed != want.colour) {
+                wrong.push_back(SpaceMismatch{ want.position_id, want.colour, observed });
+            }
+        }
+
+        streak = wrong.empty() ? streak + 1 : 0;
+        if (streak >= requiredFrames) {
+            currentState = VERIFY_CONFIRMED;
+        }
+        else if (now >= deadline && !wrong.empty()) {
+            mismatches = wrong;
+            currentState = VERIFY_MISMATCH;
+        }
+        return currentState;
+    }
+
+private:
+    unsigned long command = 0;
+    std::vector<ExpectedSpace> expected;
+    std::chrono::steady_clock::time_point deadline;
+    bool acknowledged = false;
+    int streak = 0;
+    std::vector<SpaceMismatch> mismatches;
+    VerifyState currentState = VERIFY_IDLE;
+    std::vector<int> observedByPosition; // Latest colour per position_id, -1 where unknown
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "board_tables.hpp"
+
+// Framed robot protocol. Instead of one command byte followed by a 0 "reset" byte, the host
+// sends a frame that can carry a whole plan of pick/place operations:
+//
+//   0xA5 0x5A | length | seq | type | payload (length bytes) | CRC-16 high | CRC-16 low
+//
+// The CRC is CRC-16/CCITT (polynomial 0x1021, initial 0xFFFF) over length, seq, type and the
+// payload. Frame types:
+//
+//   FRAME_PLAN      host -> controller  count, then a (pick, place) position_id pair per op
+//   FRAME_HOME      host -> controller  no payload
+//   FRAME_PROGRESS  controller -> host  seq of the plan; payload: ops completed so far
+//   FRAME_ACK       controller -> host  seq of the plan; payload: status, ops completed
+//
+// Position ids are the board's 1-based position_id values, so any space on any board size up
+// to MAX_BOARD_SPACES can be addressed.
+// Controllers that only understand the single-byte commands are driven in legacy mode.
+const uint8_t FRAME_SYNC1 = 0xA5;
+const uint8_t FRAME_SYNC2 = 0x5A;
+const size_t FRAME_MAX_PAYLOAD = 255;
+const size_t FRAME_MAX_OPS = (FRAME_MAX_PAYLOAD - 1) / 2;
+
+enum FrameType {
+    FRAME_PLAN = 0x01,
+    FRAME_HOME = 0x02,
+    FRAME_ACK = 0x81,
+    FRAME_PROGRESS = 0x82
+};
+
+enum FrameStatus {
+    FRAME_STATUS_DONE = 0,
+    FRAME_STATUS_ERROR = 1,
+    FRAME_STATUS_REJECTED = 2 // Malformed or unsupported frame; nothing was moved
+};
+
+// Legacy single-byte command for sending the arm home
+const unsigned char LEGACY_HOME_CODE = CMD_HOME;
+
+// One pick/place operation between two board positions
+struct RobotOp {
+    uint8_t pick;
+    uint8_t place;
+};
+
+struct Frame {
+    uint8_t seq;
+    uint8_t type;
+    std::vector<uint8_t> payload;
+};
+
+inline uint16_t crc16Ccitt(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Serialises a frame including the sync bytes and CRC; the payload must fit FRAME_MAX_PAYLOAD
+inline std::vector<uint8_t> encodeFrame(const Frame& frame) {
+    std::vector<uint8_t> bytes;
+    bytes.reserve(frame.payload.size() + 7);
+    bytes.push_back(FRAME_SYNC1);
+    bytes.push_back(FRAME_SYNC2);
+    bytes.push_back((uint8_t)frame.payload.size());
+    bytes.push_back(frame.seq);
+    bytes.push_back(frame.type);
+    for (uint8_t byte : frame.payload) bytes.push_back(byte);
+    uint16_t crc = crc16Ccitt(bytes.data() + 2, bytes.size() - 2);
+    bytes.push_back((uint8_t)(crc >> 8));
+    bytes.push_back((uint8_t)(crc & 0xFF));
+    return bytes;
+}
+
+inline std::vector<uint8_t> encodePlanPayload(const std::vector<RobotOp>& ops) {
+    std::vector<uint8_t> payload = { (uint8_t)ops.size() };
+    for (const RobotOp& op : ops) {
+        payload.push_back(op.pick);
+        payload.push_back(op.place);
+    }
+    return payload;
+}
+
+inline bool decodePlanPayload(const std::vector<uint8_t>& payload, std::vector<RobotOp>& ops) {
+    if (payload.empty() || payload.size() != 1 + 2 * (size_t)payload[0]) return false;
+    ops.clear();
+    for (size_t i = 1; i < payload.size(); i += 2) {
+        ops.push_back(RobotOp{ payload[i], payload[i + 1] });
+    }
+    return true;
+}
+
+// Translates a legacy pick/place (C1 row -> C3 row) or reset (C3 row -> C1 row) byte into the
+// operation it performs on a 3x3 board; returns false for home, clear and unknown codes
+inline bool opFromLegacyCode(unsigned char code, RobotOp& op) {
+    int pickRow, placeRow, pickCol, placeCol;
+    if (code >= 129 && code <= 139) {
+        int value = code - 128;
+        pickRow = (value - 1) / 4 + 1;
+        placeRow = value - (pickRow - 1) * 4;
+        pickCol = 3;
+        placeCol = 1;
+    }
+    else if (code >= 1 && code < LEGACY_HOME_CODE) {
+        pickRow = ((code - 1) >> 4) + 1;
+        placeRow = ((code - 1) & 0x0F) + 1;
+        pickCol = 1;
+        placeCol = 3;
+    }
+    else {
+        return false;
+    }
+    int pick = boardPositionId(pickRow, pickCol);
+    int place = boardPositionId(placeRow, placeCol);
+    if (pick < 0 || place < 0) return false;
+
+    op.pick = (uint8_t)pick;
+    op.place = (uint8_t)place;
+    return true;
+}
+
+// Reassembles frames from a byte stream. Bytes outside a frame are skipped and a frame with
+// a bad CRC is dropped, after which the parser resynchronises on the next sync bytes.
+class FrameParser {
+public:
+    // Feeds one byte; returns true and fills 'frame' when it completes a valid frame
+    bool push(uint8_t byte, Frame& frame) {
+        switch (state) {
+        case WAIT_SYNC1:
+            if (byte == FRAME_SYNC1) state = WAIT_SYNC2;
+            return false;
+        case WAIT_SYNC2:
+            state = (byte == FRAME_SYNC2) ? WAIT_HEADER : (byte == FRAME_SYNC1 ? WAIT_SYNC2 : WAIT_SYNC1);
+            header.clear();
+            return false;
+        case WAIT_HEADER:
+            header.push_back(byte);
+            if (header.size() == 3) {
+                remaining = header[0] + 2; // Payload plus CRC
+                state = WAIT_BODY;
+            }
+            return false;
+        case WAIT_BODY:
+            header.push_back(byte);
+            if (--remaining > 0) return false;
+            state = WAIT_SYNC1;
+
+            uint16_t received = (uint16_t)((header[header.size() - 2] << 8) | header[header.size() - 1]);
+            if (crc16Ccitt(header.data(), header.size() - 2) != received) {
+                crcErrors++;
+                return false;
+            }
+            frame.seq = header[1];
+            frame.type = header[2];
+            frame.payload.assign(header.begin() + 3, header.end() - 2);
+            return true;
+        }
+        return false;
+    }
+
+    // True while part of a frame has been received
+    bool inFrame() const {
+        return state != WAIT_SYNC1;
+    }
+
+    unsigned long crcErrors = 0;
+
+private:
+    enum State { WAIT_SYNC1, WAIT_SYNC2, WAIT_HEADER, WAIT_BODY };
+
+    State state = WAIT_SYNC1;
+    std::vector<uint8_t> header; // length, seq, type, payload, CRC
+    size_t remaining = 0;
+};
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <libserialport.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "robot_protocol.hpp"
+
+// Bytes the controller sends back when it has finished (or failed) the current command
+const unsigned char ACK_DONE = 'D';
+const unsigned char ACK_ERROR = 'E';
+
+// Colour a space should show once a command has finished
+struct ExpectedSpace {
+    int position_id;
+    int colour;
+};
+
+// How commands are put on the wire
+enum RobotProtocol {
+    PROTOCOL_LEGACY, // One command byte, cleared with a 0 byte; acknowledged with 'D'/'E'
+    PROTOCOL_FRAMED  // One CRC-checked frame per command (see robot_protocol.hpp)
+};
+
+// One robot command: the code is written and held until the controller acknowledges it or
+// 'hold' (the worst-case duration) runs out, then cleared with a 0 byte. The queue then
+// waits 'settle' before starting the next command. Commands with 'expected' spaces are
+// finished by whoever watches the board calling completeActive().
+//
+// In framed mode 'ops' is sent as a single plan frame (a whole reset can be one command);
+// without ops the legacy code is translated, so single-byte callers work in both modes.
+struct RobotCommand {
+    RobotCommand() {}
+    RobotCommand(unsigned char code, std::chrono::milliseconds hold, std::chrono::milliseconds settle, const std::string& label)
+        : code(code), hold(hold), settle(settle), label(label) {}
+
+    unsigned char code = 0;
+    std::chrono::milliseconds hold{ 0 };
+    std::chrono::milliseconds settle{ 0 };
+    std::string label;
+    std::vector<ExpectedSpace> expected;
+    unsigned long id = 0; // Assigned by the queue on submit
+    std::vector<RobotOp> ops;
+};
+
+struct CommandResult {
+    bool ok;
+    std::string message;
+    bool confirmed = false; // True when the board was seen in its expected state
+    bool observedEnd = false; // True when ACK_DONE or the camera marked the end, so elapsed is a real duration
+    std::chrono::milliseconds elapsed{ 0 }; // From sending the command until it finished
+};
+
+// Serialises robot commands onto a dedicated worker thread so the caller never blocks
+// while the arm moves. Each submitted command returns a future for its result; an
+// optional callback is also queued and run on whichever thread calls dispatchCompletions(),
+// so board state can be updated from the main loop without extra locking.
+//
+// When the port is open for reading, a second thread watches for ACK_DONE/ACK_ERROR bytes
+// (or, in framed mode, the ACK frame for the plan in flight) and ends the active command
+// as soon as one arrives. Without an acknowledgement the
+// command falls back to its fixed hold time, unless requireAck is set, in which case
+// running out of time is reported as a failure.
+//
+// Commands that carry expected spaces are completed externally once the board has been
+// seen in the expected state (or found not to be); the hold time plus confirmMargin is
+// then only a safety net. If the observer stops watching mid-command (see
+// setConfirmationAvailable()) the controller's acknowledgement ends the command instead.
+// A failed command cancels everything queued after it.
+class RobotCommandQueue {
+public:
+    typedef std::function<void(const RobotCommand&, const CommandResult&)> Callback;
+
+    // Extra time a command with expected spaces waits for external confirmation
+    std::chrono::milliseconds confirmMargin{ 2000 };
+
+    // Serial timeouts for each command write and each acknowledgement poll
+    unsigned int writeTimeoutMs = 100;
+    unsigned int readTimeoutMs = 50;
+
+    // Wire format; set before start()
+    RobotProtocol protocol = PROTOCOL_LEGACY;
+
+    ~RobotCommandQueue() {
+        stop();
+    }
+
+    // Starts the worker; a null port runs in simulation mode and skips the writes.
+    // listenForAcks needs the port opened with SP_MODE_READ_WRITE.
+    void start(struct sp_port* serialPort, bool listenForAcks, bool ackRequired = false) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        port = serialPort;
+        readAcks = listenForAcks && port;
+        requireAck = ackRequired && readAcks;
+        running = true;
+        worker = std::thread(&RobotCommandQueue::workerLoop, this);
+        if (readAcks) {
+            ackReader = std::thread(&RobotCommandQueue::ackReaderLoop, this);
+        }
+    }
+
+    // Cancels anything still queued and stops the worker. The command in progress is given
+    // up to 'drain' to finish on its own (acknowledgement, confirmation or hold time) and is
+    // interrupted after that.
+    void stop(std::chrono::milliseconds drain = std::chrono::milliseconds(0)) {
+        cancelPending();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) return;
+            if (drain.count() > 0) {
+                wake.wait_for(lock, drain, [this] { return !active; });
+            }
+            running = false;
+        }
+        wake.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+        if (ackReader.joinable()) {
+            ackReader.join();
+        }
+        cancelPending();
+    }
+
+    std::future<CommandResult> submit(const RobotCommand& command, Callback onDone = Callback()) {
+        Job job;
+        job.command = command;
+        job.onDone = onDone;
+        std::future<CommandResult> result = job.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job.command.id = ++lastId;
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_all();
+        return result;
+    }
+
+    // Drops every command that has not started yet; their results report cancellation
+    void cancelPending() {
+        std::deque<Job> cancelled;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled.swap(jobs);
+        }
+        for (auto& job : cancelled) {
+            finish(job, CommandResult{ false, "Cancelled" });
+        }
+    }
+
+    // Number of commands queued or in progress
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs.size() + (active ? 1 : 0);
+    }
+
+    bool busy() const {
+        return pending() > 0;
+    }
+
+    // Copies the command currently being executed; acknowledged reports whether the
+    // controller has already sent ACK_DONE for it
+    bool activeCommand(RobotCommand& command, bool& acknowledged) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!awaitingResult) return false;
+        command = current;
+        acknowledged = (ack == ACK_DONE);
+        return true;
+    }
+
+    // Tells the queue whether the external observer is still watching the board. While it is
+    // not, confirmable commands also end on ACK_DONE, as nobody is left to complete them.
+    void setConfirmationAvailable(bool available) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (confirming == available) return;
+        confirming = available;
+        wake.notify_all();
+    }
+
+    // Finishes the active command with an externally determined result (e.g. vision)
+    void completeActive(unsigned long id, const CommandResult& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!awaitingResult || current.id != id) return;
+        external = result;
+        externalDone = true;
+        wake.notify_all();
+    }
+
+    // Runs the callbacks of finished commands on the calling thread
+    void dispatchCompletions() {
+        std::deque<Completion> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.swap(completed);
+        }
+        for (auto& done : ready) {
+            done.onDone(done.command, done.result);
+        }
+    }
+
+private:
+    struct Job {
+        RobotCommand command;
+        std::promise<CommandResult> promise;
+        Callback onDone;
+    };
+
+    struct Completion {
+        RobotCommand command;
+        CommandResult result;
+        Callback onDone;
+    };
+
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return !running || !jobs.empty(); });
+            if (!running) break;
+
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            active = true;
+            lock.unlock();
+
+            auto started = std::chrono::steady_clock::now();
+            CommandResult result = run(job.command);
+            result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+            finish(job, result);
+
+            // The rest of a plan cannot run on a board that is not in the expected state
+            if (!result.ok) {
+                cancelPending();
+            }
+
+            lock.lock();
+            active = false;
+            wake.notify_all(); // stop() may be waiting for this command to drain
+            if (job.command.settle.count() > 0) {
+                wake.wait_for(lock, job.command.settle, [this] { return !running; });
+            }
+        }
+    }
+
+    // Sends the command, holds it until acknowledged or timed out, then clears it with a 0 byte
+    CommandResult run(const RobotCommand& command) {
+        if (!port) {
+            std::cout << "Serial port not available!" << std::endl;
+            return CommandResult{ true, "Simulated" };
+        }
+
+        // Drop any acknowledgement left over from an earlier command
+        if (readAcks) {
+            sp_flush(port, SP_BUF_INPUT);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ack = 0;
+            awaitingAck = readAcks;
+            externalDone = false;
+        }
+
+        std::vector<uint8_t> bytes;
+        if (!encode(command, bytes)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            awaitingAck = false;
+            return CommandResult{ false, std::string("Command has no ") + (protocol == PROTOCOL_FRAMED ? "framed" : "single-byte") + " encoding" };
+        }
+        if (sp_blocking_write(port, bytes.data(), bytes.size(), writeTimeoutMs) < (int)bytes.size()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            awaitingAck = false;
+            return CommandResult{ false, "Write failed" };
+        }
+        if (protocol == PROTOCOL_FRAMED) {
+            std::cout << "Frame sent: seq " << int(frameSeq) << ", " << bytes.size() << " bytes" << std::endl;
+        }
+        else {
+            std::cout << "Command sent: " << int(command.code) << std::endl;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        bool confirmable = !command.expected.empty();
+        unsigned char received;
+        bool stopped;
+        bool completedExternally;
+        CommandResult externalResult;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            current = command;
+            awaitingResult = true;
+            if (confirmable) {
+                // Only the external observer or an error ends a confirmable command early,
+                // unless the observer stops watching; then the acknowledgement counts again
+                wake.wait_for(lock, command.hold + confirmMargin,
+                    [this] { return !running || externalDone || ack == ACK_ERROR || (!confirming && ack != 0); });
+            }
+            else {
+                wake.wait_for(lock, command.hold, [this] { return !running || ack != 0; });
+            }
+            received = ack;
+            completedExternally = externalDone;
+            externalResult = external;
+            stopped = !running && received == 0 && !externalDone;
+            awaitingAck = false;
+            awaitingResult = false;
+        }
+
+        // Frames need no reset byte; the controller tracks each plan by its sequence number
+        if (protocol == PROTOCOL_LEGACY) {
+            unsigned char cmd = 0;
+            sp_blocking_write(port, &cmd, 1, writeTimeoutMs);
+            sp_drain(port);
+            std::cout << "Command reset" << std::endl;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        if (stopped) {
+            return CommandResult{ false, "Interrupted" };
+        }
+        if (received == ACK_ERROR) {
+            return CommandResult{ false, "Robot reported an error" };
+        }
+        if (completedExternally) {
+            externalResult.observedEnd = externalResult.confirmed;
+            return externalResult;
+        }
+        if (received == ACK_DONE) {
+            CommandResult result = { true, "Acknowledged after " + std::to_string(elapsed.count()) + " ms" };
+            result.observedEnd = true;
+            return result;
+        }
+        if (requireAck) {
+            return CommandResult{ false, "No acknowledgement within " + std::to_string(command.hold.count()) + " ms" };
+        }
+        return CommandResult{ true, "Completed" };
+    }
+
+    // Watches the port for acknowledgement bytes and wakes the worker when one arrives
+    void ackReaderLoop() {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!running) break;
+            }
+
+            unsigned char byte = 0;
+            if (sp_blocking_read(port, &byte, 1, readTimeoutMs) != 1) continue;
+            if (protocol == PROTOCOL_FRAMED) {
+                // Translate the plan's acknowledgement frame into the legacy ack bytes
+                Frame frame;
+                if (!parser.push(byte, frame) || frame.type != FRAME_ACK || frame.payload.empty()) continue;
+                std::lock_guard<std::mutex> lock(mutex);
+                if (frame.seq != frameSeq) continue;
+                byte = (frame.payload[0] == FRAME_STATUS_DONE) ? ACK_DONE : ACK_ERROR;
+            }
+            if (byte != ACK_DONE && byte != ACK_ERROR) continue;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (awaitingAck) {
+                ack = byte;
+                wake.notify_all();
+            }
+        }
+    }
+
+    // Builds the bytes for a command in the configured protocol
+    bool encode(const RobotCommand& command, std::vector<uint8_t>& bytes) {
+        if (protocol == PROTOCOL_LEGACY) {
+            // Moves the single-byte commands cannot address (e.g. on larger boards) have no code
+            if (command.code == CMD_CLEAR) return false;
+            bytes.assign(1, command.code);
+            return true;
+        }
+
+        Frame frame;
+        frame.type = FRAME_PLAN;
+        std::vector<RobotOp> ops = command.ops;
+        RobotOp op;
+        if (ops.empty() && command.code == LEGACY_HOME_CODE) {
+            frame.type = FRAME_HOME;
+        }
+        else if (ops.empty() && opFromLegacyCode(command.code, op)) {
+            ops.push_back(op);
+        }
+        if (frame.type == FRAME_PLAN) {
+            if (ops.empty() || ops.size() > FRAME_MAX_OPS) return false;
+            frame.payload = encodePlanPayload(ops);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        frame.seq = ++frameSeq;
+        bytes = encodeFrame(frame);
+        return true;
+    }
+
+    void finish(Job& job, const CommandResult& result) {
+        job.promise.set_value(result);
+        if (job.onDone) {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(Completion{ job.command, result, job.onDone });
+        }
+    }
+
+    struct sp_port* port = nullptr;
+    bool readAcks = false;
+    bool requireAck = false;
+    std::thread worker;
+    std::thread ackReader;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    std::deque<Completion> completed;
+    bool running = false;
+    bool active = false;
+    bool awaitingAck = false;
+    unsigned char ack = 0; // Acknowledgement received for the active command, 0 if none yet
+    unsigned long lastId = 0;
+    RobotCommand current;  // Command being executed while awaitingResult is set
+    bool awaitingResult = false;
+    bool externalDone = false;
+    bool confirming = true; // See setConfirmationAvailable()
+    CommandResult external;
+    uint8_t frameSeq = 0;  // Sequence number of the last frame sent
+    FrameParser parser;    // Only used by the ack reader
+};
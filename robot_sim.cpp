@@ -0,0 +1,371 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "robot_protocol.hpp"
+
+// Robot controller simulator for running the host programs without hardware (Linux only).
+// It opens a pseudo-terminal, prints the slave device path (optionally symlinked to a fixed
+// name) and behaves like the arm's controller on the other end of the serial line.
+//
+// Legacy single-byte commands:
+//   1-35     pick/place: ((pick_row-1)<<4 | (place_row-1)) + 1, C1 pick row -> C3 place row
+//   129-139  reset moves (resetCode in board_tables.hpp): 128 + (pick_row-1)*4 + place_row, C3 -> C1
+//   64       home
+//   0        clear; the host writes it after every command
+// Every valid command replies ACK_DONE ('D') once its motion time has passed; unknown codes,
+// commands arriving while the arm is still moving and injected failures reply ACK_ERROR ('E').
+//
+// Legacy commands only exist for the 3x3 board; with --board set to another size they are
+// refused and only framed plans are accepted.
+//
+// Framed commands (robot_protocol.hpp) are recognised by their sync bytes. A plan runs its
+// operations back to back, sends a progress frame after each and an ack frame at the end;
+// --overlap-ms shortens every operation after the first to model the controller pipelining
+// the next pick while the previous place finishes.
+//
+// Usage: robot_sim [--link <path>] [--move-ms <n>] [--reset-ms <n>] [--home-ms <n>]
+//                  [--overlap-ms <n>] [--jitter-ms <n>] [--fail-rate <0-1>] [--no-ack]
+//                  [--check-board] [--board <rows>x<cols>] [--quiet]
+
+using namespace std;
+using namespace std::chrono;
+
+const unsigned char ACK_DONE = 'D';
+const unsigned char ACK_ERROR = 'E';
+
+struct SimConfig {
+    string link;
+    int moveMs = 1500;
+    int resetMs = 1500;
+    int homeMs = 1000;
+    int overlapMs = 0;
+    int jitterMs = 0;
+    double failRate = 0.0;
+    bool sendAcks = true;
+    bool checkBoard = false; // Track which spaces hold blocks and refuse impossible moves
+    BoardGeometry board;
+    bool quiet = false;
+};
+
+// A command being carried out: one legacy byte, or a framed plan of several operations
+struct Job {
+    bool framed;
+    uint8_t seq;
+    bool home;
+    vector<RobotOp> ops;
+    size_t next;     // Operation in progress
+    bool fails;      // Injected failure for this job
+    steady_clock::time_point started;
+    steady_clock::time_point stepDoneAt;
+};
+
+volatile sig_atomic_t stopRequested = 0;
+
+void onStopSignal(int) {
+    stopRequested = 1;
+}
+
+string describeOp(const RobotOp& op, int cols) {
+    int pick = op.pick - 1, place = op.place - 1;
+    return "R" + to_string(pick / cols + 1) + "C" + to_string(pick % cols + 1) + " -> R" +
+        to_string(place / cols + 1) + "C" + to_string(place % cols + 1);
+}
+
+// Opens the master side of a new pty in raw mode and returns its fd, or -1
+int openPseudoTerminal(string& slavePath) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) return -1;
+    if (grantpt(master) != 0 || unlockpt(master) != 0) {
+        close(master);
+        return -1;
+    }
+
+    const char* name = ptsname(master);
+    if (!name) {
+        close(master);
+        return -1;
+    }
+    slavePath = name;
+
+    // Raw bytes both ways: no echo, no line buffering, no translation of 0 or CR
+    struct termios settings;
+    if (tcgetattr(master, &settings) == 0) {
+        cfmakeraw(&settings);
+        tcsetattr(master, TCSANOW, &settings);
+    }
+    return master;
+}
+
+class RobotSimulator {
+public:
+    RobotSimulator(int fd, const SimConfig& simConfig)
+        : master(fd), config(simConfig), random((unsigned)steady_clock::now().time_since_epoch().count()) {
+        // Blocks start in column 1
+        occupied.assign(config.board.spaces() + 1, false);
+        for (int position = 1; position <= config.board.spaces(); position++) {
+            occupied[position] = ((position - 1) % config.board.cols == 0);
+        }
+    }
+
+    bool busy() const {
+        return active;
+    }
+
+    steady_clock::time_point nextEvent() const {
+        return job.stepDoneAt;
+    }
+
+    void receive(const unsigned char* bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            Frame frame;
+            if (parser.inFrame() || bytes[i] == FRAME_SYNC1) {
+                if (parser.push(bytes[i], frame)) receiveFrame(frame);
+                continue;
+            }
+            receiveLegacy(bytes[i]);
+        }
+    }
+
+    // Finishes the operation in progress if its time has come
+    void update() {
+        if (!active || steady_clock::now() < job.stepDoneAt) return;
+
+        bool ok = !job.fails;
+        if (ok && !job.home && config.checkBoard) {
+            const RobotOp& op = job.ops[job.next];
+            if (!occupied[op.pick] || occupied[op.place]) {
+                ok = false;
+                log("   nothing to pick or place is taken");
+            }
+            else {
+                occupied[op.pick] = false;
+                occupied[op.place] = true;
+            }
+        }
+
+        if (ok && !job.home) {
+            job.next++;
+            if (job.framed) {
+                sendFrame(FRAME_PROGRESS, job.seq, { (uint8_t)job.next });
+            }
+            if (job.next < job.ops.size()) {
+                scheduleStep();
+                return;
+            }
+        }
+        finishJob(ok);
+    }
+
+    void printSummary() const {
+        cout << endl << "Commands received: " << received << endl;
+        cout << "Completed:         " << completed << endl;
+        cout << "Errors:            " << errors << endl;
+        cout << "Operations run:    " << operations << endl;
+        if (jobsTimed > 0) {
+            cout << "Mean command time: " << totalJobMs / jobsTimed << " ms" << endl;
+        }
+        if (parser.crcErrors > 0) {
+            cout << "Frames dropped:    " << parser.crcErrors << " (bad CRC)" << endl;
+        }
+    }
+
+private:
+    void receiveLegacy(unsigned char code) {
+        if (code == 0) return; // Clear byte after every legacy command
+        received++;
+
+        RobotOp op;
+        bool home = (code == LEGACY_HOME_CODE);
+        bool valid = home || (config.board.legacyCommands() && opFromLegacyCode(code, op));
+        if (!valid || active) {
+            // Unknown codes and commands sent mid-move are refused
+            log("<- " + to_string(int(code)) + (valid ? " while moving" : " invalid") + " (rejected)");
+            errors++;
+            sendByte(ACK_ERROR);
+            return;
+        }
+
+        log("<- " + to_string(int(code)) + " " + (home ? "home" : describeOp(op, config.board.cols)));
+        startJob(false, 0, home, home ? vector<RobotOp>() : vector<RobotOp>{ op });
+    }
+
+    void receiveFrame(const Frame& frame) {
+        received++;
+        vector<RobotOp> ops;
+        bool valid = (frame.type == FRAME_HOME && frame.payload.empty()) ||
+            (frame.type == FRAME_PLAN && decodePlanPayload(frame.payload, ops) && !ops.empty());
+        for (const RobotOp& op : ops) {
+            int spaces = config.board.spaces();
+            if (op.pick < 1 || op.pick > spaces || op.place < 1 || op.place > spaces) valid = false;
+        }
+
+        if (!valid || active) {
+            log("<- frame " + to_string(int(frame.seq)) + (valid ? " while moving" : " invalid") + " (rejected)");
+            errors++;
+            sendFrame(FRAME_ACK, frame.seq, { (uint8_t)FRAME_STATUS_REJECTED, 0 });
+            return;
+        }
+
+        string text = "<- frame " + to_string(int(frame.seq)) + ":";
+        if (frame.type == FRAME_HOME) text += " home";
+        for (const RobotOp& op : ops) text += " [" + describeOp(op, config.board.cols) + "]";
+        log(text);
+        startJob(true, frame.seq, frame.type == FRAME_HOME, ops);
+    }
+
+    void startJob(bool framed, uint8_t seq, bool home, const vector<RobotOp>& ops) {
+        job.framed = framed;
+        job.seq = seq;
+        job.home = home;
+        job.ops = ops;
+        job.next = 0;
+        job.fails = uniform_real_distribution<double>(0.0, 1.0)(random) < config.failRate;
+        job.started = steady_clock::now();
+        active = true;
+        scheduleStep();
+    }
+
+    void scheduleStep() {
+        int stepMs = config.homeMs;
+        if (!job.home) {
+            // Moves into column 1 are the reset direction
+            const RobotOp& op = job.ops[job.next];
+            stepMs = ((op.place - 1) % config.board.cols == 0) ? config.resetMs : config.moveMs;
+            if (job.next > 0) stepMs = max(0, stepMs - config.overlapMs);
+            operations++;
+        }
+        if (config.jitterMs > 0) {
+            stepMs += uniform_int_distribution<int>(0, config.jitterMs)(random);
+        }
+        job.stepDoneAt = steady_clock::now() + milliseconds(stepMs);
+    }
+
+    void finishJob(bool ok) {
+        active = false;
+        double jobMs = duration<double, milli>(steady_clock::now() - job.started).count();
+        totalJobMs += jobMs;
+        jobsTimed++;
+        if (ok) completed++;
+        else errors++;
+
+        if (job.framed) {
+            log("-> ack " + to_string(int(job.seq)) + (ok ? " done" : " error") + " after " + to_string((int)jobMs) + " ms");
+            uint8_t status = ok ? FRAME_STATUS_DONE : FRAME_STATUS_ERROR;
+            sendFrame(FRAME_ACK, job.seq, { status, (uint8_t)job.next });
+        }
+        else {
+            log(string("-> ") + char(ok ? ACK_DONE : ACK_ERROR) + " after " + to_string((int)jobMs) + " ms");
+            sendByte(ok ? ACK_DONE : ACK_ERROR);
+        }
+    }
+
+    void sendByte(unsigned char byte) {
+        if (config.sendAcks && write(master, &byte, 1) != 1) {
+            perror("write");
+        }
+    }
+
+    void sendFrame(uint8_t type, uint8_t seq, const vector<uint8_t>& payload) {
+        if (!config.sendAcks) return;
+        vector<uint8_t> bytes = encodeFrame(Frame{ seq, type, payload });
+        if (write(master, bytes.data(), bytes.size()) != (ssize_t)bytes.size()) {
+            perror("write");
+        }
+    }
+
+    void log(const string& text) const {
+        if (!config.quiet) cout << text << endl;
+    }
+
+    int master;
+    SimConfig config;
+    mt19937 random;
+    FrameParser parser;
+    vector<bool> occupied; // Indexed by position_id
+    bool active = false;
+    Job job = Job();
+    long received = 0, completed = 0, errors = 0, operations = 0, jobsTimed = 0;
+    double totalJobMs = 0;
+};
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--link" && hasValue) config.link = argv[++i];
+        else if (arg == "--move-ms" && hasValue) config.moveMs = atoi(argv[++i]);
+        else if (arg == "--reset-ms" && hasValue) config.resetMs = atoi(argv[++i]);
+        else if (arg == "--home-ms" && hasValue) config.homeMs = atoi(argv[++i]);
+        else if (arg == "--overlap-ms" && hasValue) config.overlapMs = atoi(argv[++i]);
+        else if (arg == "--jitter-ms" && hasValue) config.jitterMs = atoi(argv[++i]);
+        else if (arg == "--fail-rate" && hasValue) config.failRate = atof(argv[++i]);
+        else if (arg == "--no-ack") config.sendAcks = false;
+        else if (arg == "--check-board") config.checkBoard = true;
+        else if (arg == "--quiet") config.quiet = true;
+        else if (arg == "--board" && hasValue && parseBoardGeometry(argv[i + 1], config.board)) i++;
+        else {
+            cout << "Usage: robot_sim [--link <path>] [--move-ms <n>] [--reset-ms <n>] [--home-ms <n>]"
+                << " [--overlap-ms <n>] [--jitter-ms <n>] [--fail-rate <0-1>] [--no-ack] [--check-board]"
+                << " [--board <rows>x<cols>] [--quiet]" << endl;
+            return 1;
+        }
+    }
+
+    string slavePath;
+    int master = openPseudoTerminal(slavePath);
+    if (master < 0) {
+        perror("Cannot open pseudo-terminal");
+        return 1;
+    }
+
+    // Hold the slave open ourselves so the master does not see a hang-up between host runs
+    int slaveHold = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+
+    if (!config.link.empty()) {
+        unlink(config.link.c_str());
+        if (symlink(slavePath.c_str(), config.link.c_str()) != 0) {
+            perror("Cannot create link");
+        }
+    }
+
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+
+    cout << "Robot simulator listening on " << slavePath;
+    if (!config.link.empty()) cout << " (" << config.link << ")";
+    cout << endl;
+
+    RobotSimulator simulator(master, config);
+    while (!stopRequested) {
+        // Sleep until a byte arrives or the current operation finishes
+        int timeoutMs = 100;
+        if (simulator.busy()) {
+            auto remaining = duration_cast<milliseconds>(simulator.nextEvent() - steady_clock::now()).count();
+            timeoutMs = (int)max<long long>(0, min<long long>(remaining, 100));
+        }
+        struct pollfd fds = { master, POLLIN, 0 };
+        if (poll(&fds, 1, timeoutMs) > 0 && (fds.revents & POLLIN)) {
+            unsigned char bytes[256];
+            ssize_t count = read(master, bytes, sizeof(bytes));
+            if (count > 0) simulator.receive(bytes, (size_t)count);
+        }
+        simulator.update();
+    }
+
+    simulator.printSummary();
+
+    if (!config.link.empty()) unlink(config.link.c_str());
+    if (slaveHold >= 0) close(slaveHold);
+    close(master);
+    return 0;
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <libserialport.h>
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Settings for one serial link. Defaults match the original hardcoded COM3 at 9600 8N1.
+struct SerialConfig {
+    std::string name = "robot"; // Used to pick a port when several are configured
+    std::string device = "COM3";
+    int baud = 9600;
+    int bits = 8;
+    sp_parity parity = SP_PARITY_NONE;
+    int stopBits = 1;
+    sp_flowcontrol flowControl = SP_FLOWCONTROL_NONE;
+    unsigned int writeTimeoutMs = 100;
+    unsigned int readTimeoutMs = 50;
+    bool framedProtocol = false; // Robot controller speaks the framed protocol (robot_protocol.hpp)
+};
+
+namespace serial_detail {
+    inline std::string trim(const std::string& text) {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) return "";
+        size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+
+    inline bool parsePositive(const std::string& text, int& value) {
+        char* end = nullptr;
+        long parsed = strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || parsed <= 0) return false;
+        value = (int)parsed;
+        return true;
+    }
+}
+
+// Applies one "key = value" setting; returns false for an unknown key or bad value.
+// Keys: device, baud, bits, parity (none/odd/even/mark/space), stopbits,
+// flow (none/xonxoff/rtscts/dtrdsr), write_timeout_ms, read_timeout_ms, protocol (legacy/framed)
+inline bool setSerialOption(SerialConfig& config, const std::string& key, const std::string& value) {
+    int number = 0;
+    if (key == "device") {
+        config.device = value;
+        return !value.empty();
+    }
+    if (key == "baud") {
+        if (!serial_detail::parsePositive(value, number)) return false;
+        config.baud = number;
+        return true;
+    }
+    if (key == "bits") {
+        if (!serial_detail::parsePositive(value, number) || number < 5 || number > 8) return false;
+        config.bits = number;
+        return true;
+    }
+    if (key == "stopbits") {
+        if (!serial_detail::parsePositive(value, number) || number > 2) return false;
+        config.stopBits = number;
+        return true;
+    }
+    if (key == "write_timeout_ms") {
+        if (!serial_detail::parsePositive(value, number)) return false;
+        config.writeTimeoutMs = number;
+        return true;
+    }
+    if (key == "read_timeout_ms") {
+        if (!serial_detail::parsePositive(value, number)) return false;
+        config.readTimeoutMs = number;
+        return true;
+    }
+    if (key == "parity") {
+        if (value == "none") config.parity = SP_PARITY_NONE;
+        else if (value == "odd") config.parity = SP_PARITY_ODD;
+        else if (value == "even") config.parity = SP_PARITY_EVEN;
+        else if (value == "mark") config.parity = SP_PARITY_MARK;
+        else if (value == "space") config.parity = SP_PARITY_SPACE;
+        else return false;
+        return true;
+    }
+    if (key == "protocol") {
+        if (value == "legacy") config.framedProtocol = false;
+        else if (value == "framed") config.framedProtocol = true;
+        else return false;
+        return true;
+    }
+    if (key == "flow") {
+        if (value == "none") config.flowControl = SP_FLOWCONTROL_NONE;
+        else if (value == "xonxoff") config.flowControl = SP_FLOWCONTROL_XONXOFF;
+        else if (value == "rtscts") config.flowControl = SP_FLOWCONTROL_RTSCTS;
+        else if (value == "dtrdsr") config.flowControl = SP_FLOWCONTROL_DTRDSR;
+        else return false;
+        return true;
+    }
+    return false;
+}
+
+// Reads port settings from a file of "key = value" lines. A "[name]" line starts a new port;
+// settings before the first section belong to a port called "robot". '#' starts a comment.
+inline bool loadSerialConfigFile(const std::string& path, std::vector<SerialConfig>& configs) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "Cannot open serial config " << path << std::endl;
+        return false;
+    }
+
+    std::vector<SerialConfig> loaded;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = serial_detail::trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        if (line.front() == '[' && line.back() == ']') {
+            SerialConfig config;
+            config.name = serial_detail::trim(line.substr(1, line.size() - 2));
+            loaded.push_back(config);
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (loaded.empty()) loaded.push_back(SerialConfig());
+        if (equals == std::string::npos ||
+            !setSerialOption(loaded.back(), serial_detail::trim(line.substr(0, equals)),
+                serial_detail::trim(line.substr(equals + 1)))) {
+            std::cout << path << ":" << lineNumber << ": bad serial setting '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+
+    configs.insert(configs.end(), loaded.begin(), loaded.end());
+    return true;
+}
+
+// Consumes a serial option at argv[i] (advancing i past its value) and returns true if it
+// was one. --port starts a new port each time it is given; --baud, --bits, --parity,
+// --stopbits, --flow, --write-timeout, --read-timeout and --protocol apply to the most recent port.
+// Ports after the first are named after their device.
+// --serial-config <file> adds the ports from a config file. Sets error on a bad value.
+inline bool parseSerialArg(int argc, char* argv[], int& i, std::vector<SerialConfig>& configs, bool& error) {
+    std::string arg = argv[i];
+    static const char* const options[][2] = {
+        { "--baud", "baud" }, { "--bits", "bits" }, { "--parity", "parity" },
+        { "--stopbits", "stopbits" }, { "--flow", "flow" },
+        { "--write-timeout", "write_timeout_ms" }, { "--read-timeout", "read_timeout_ms" },
+        { "--protocol", "protocol" }
+    };
+
+    if (i + 1 >= argc) return false;
+    std::string value = argv[i + 1];
+
+    if (arg == "--serial-config") {
+        i++;
+        if (!loadSerialConfigFile(value, configs)) error = true;
+        return true;
+    }
+    if (arg == "--port") {
+        i++;
+        // The first port is the robot port, including any options given before it
+        bool onlyDefault = configs.size() == 1 && configs[0].name == SerialConfig().name &&
+            configs[0].device == SerialConfig().device;
+        if (onlyDefault) {
+            configs[0].device = value;
+            return true;
+        }
+        SerialConfig config;
+        config.device = value;
+        if (!configs.empty()) config.name = value;
+        configs.push_back(config);
+        return true;
+    }
+    for (const auto& option : options) {
+        if (arg != option[0]) continue;
+        i++;
+        if (configs.empty()) configs.push_back(SerialConfig());
+        if (!setSerialOption(configs.back(), option[1], value)) {
+            std::cout << "Bad value for " << arg << ": " << value << std::endl;
+            error = true;
+        }
+        return true;
+    }
+    return false;
+}
+
+inline std::string describeSerialConfig(const SerialConfig& config) {
+    static const char parityLetter[] = { 'N', 'O', 'E', 'M', 'S' };
+    static const char* const flowNames[] = { "none", "xonxoff", "rtscts", "dtrdsr" };
+    return config.name + ": " + config.device + " " + std::to_string(config.baud) + " " +
+        std::to_string(config.bits) + parityLetter[config.parity] + std::to_string(config.stopBits) +
+        " flow " + flowNames[config.flowControl] + (config.framedProtocol ? " framed" : "");
+}
+
+// Opens and configures a port; returns nullptr (after printing why) if any step fails
+inline struct sp_port* openSerialPort(const SerialConfig& config, enum sp_mode mode) {
+    struct sp_port* port = nullptr;
+    if (sp_get_port_by_name(config.device.c_str(), &port) != SP_OK) {
+        std::cout << "Warning: Could not find serial port " << config.device << std::endl;
+        return nullptr;
+    }
+    if (sp_open(port, mode) != SP_OK) {
+        std::cout << "Warning: Could not open serial port " << config.device << std::endl;
+        sp_free_port(port);
+        return nullptr;
+    }
+
+    if (sp_set_baudrate(port, config.baud) != SP_OK ||
+        sp_set_bits(port, config.bits) != SP_OK ||
+        sp_set_parity(port, config.parity) != SP_OK ||
+        sp_set_stopbits(port, config.stopBits) != SP_OK ||
+        sp_set_flowcontrol(port, config.flowControl) != SP_OK) {
+        std::cout << "Warning: Serial port " << config.device << " rejected its settings" << std::endl;
+        sp_close(port);
+        sp_free_port(port);
+        return nullptr;
+    }
+    return port;
+}
+
+// Every port a program was configured with, opened together and looked up by name
+class SerialPortSet {
+public:
+    ~SerialPortSet() {
+        closeAll();
+    }
+
+    // Opens every configured port; ports that fail stay in the set with a null handle
+    void openAll(const std::vector<SerialConfig>& configs, enum sp_mode mode) {
+        closeAll();
+        for (const SerialConfig& config : configs) {
+            Entry entry = { config, openSerialPort(config, mode) };
+            if (entry.port) {
+                std::cout << "Serial port " << describeSerialConfig(config) << " initialized" << std::endl;
+            }
+            entries.push_back(entry);
+        }
+    }
+
+    void closeAll() {
+        for (Entry& entry : entries) {
+            if (entry.port) {
+                sp_close(entry.port);
+                sp_free_port(entry.port);
+            }
+        }
+        entries.clear();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    // Port handle by name, or nullptr if it is not configured or failed to open
+    struct sp_port* get(const std::string& name) const {
+        for (const Entry& entry : entries) {
+            if (entry.config.name == name) return entry.port;
+        }
+        return nullptr;
+    }
+
+    struct sp_port* port(size_t index) const {
+        return entries[index].port;
+    }
+
+    const SerialConfig& config(size_t index) const {
+        return entries[index].config;
+    }
+
+private:
+    struct Entry {
+        SerialConfig config;
+        struct sp_port* port;
+    };
+
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "opencv2/imgproc/imgproc.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Rolling latency figures for one stage, in milliseconds
+struct LatencySummary {
+    size_t count;
+    double minMs;
+    double meanMs;
+    double p95Ms;
+    double p99Ms;
+};
+
+// Times named stages of a processing loop with the monotonic clock. Each stage keeps its
+// most recent 'window' samples; summaries (min/mean/p95/p99) are computed from that window
+// on demand, so recording a sample is just a clock read and a ring-buffer store.
+class StageProfiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Times the enclosing block and records it against a stage when it goes out of scope
+    class Scope {
+    public:
+        Scope(StageProfiler& owner, int stageIndex) : profiler(owner), stage(stageIndex), started(Clock::now()) {}
+        ~Scope() {
+            profiler.record(stage, started, Clock::now());
+        }
+
+    private:
+        StageProfiler& profiler;
+        int stage;
+        Clock::time_point started;
+    };
+
+    explicit StageProfiler(size_t samplesPerStage = 512) : window(samplesPerStage), lastDump(Clock::now()) {}
+
+    // Registers a stage and returns the index used to record it
+    int addStage(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stage stage;
+        stage.name = name;
+        stage.samples.reserve(window);
+        stages.push_back(stage);
+        return (int)stages.size() - 1;
+    }
+
+    void record(int stage, double ms) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stage& s = stages[stage];
+        if (s.samples.size() < window) {
+            s.samples.push_back(ms);
+        }
+        else {
+            s.samples[s.next] = ms;
+        }
+        s.next = (s.next + 1) % window;
+        s.total++;
+    }
+
+    void record(int stage, Clock::time_point started, Clock::time_point finished) {
+        record(stage, std::chrono::duration<double, std::milli>(finished - started).count());
+    }
+
+    LatencySummary summary(int stage) const {
+        std::vector<double> sorted;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sorted = stages[stage].samples;
+        }
+
+        LatencySummary result = { sorted.size(), 0, 0, 0, 0 };
+        if (sorted.empty()) return result;
+
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0;
+        for (double ms : sorted) sum += ms;
+        result.minMs = sorted.front();
+        result.meanMs = sum / sorted.size();
+        result.p95Ms = sorted[(sorted.size() - 1) * 95 / 100];
+        result.p99Ms = sorted[(sorted.size() - 1) * 99 / 100];
+        return result;
+    }
+
+    size_t stageCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stages.size();
+    }
+
+    std::string stageName(int stage) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stages[stage].name;
+    }
+
+    // Formats one stage summary as "name  min/mean/p95/p99 ms"
+    std::string describe(int stage) const {
+        LatencySummary s = summary(stage);
+        char text[160];
+        snprintf(text, sizeof(text), "%-14s %6.2f %6.2f %6.2f %6.2f ms", stageName(stage).c_str(),
+            s.minMs, s.meanMs, s.p95Ms, s.p99Ms);
+        return text;
+    }
+
+    // Draws a min/mean/p95/p99 table for every stage onto a frame
+    void drawOverlay(cv::Mat& frame, cv::Point origin) const {
+        int rows = (int)stageCount() + 1;
+        cv::rectangle(frame, cv::Rect(origin.x - 5, origin.y - 15, 330, rows * 15 + 5), cv::Scalar(0, 0, 0), -1);
+        cv::putText(frame, "stage           min   mean    p95    p99", origin,
+            cv::FONT_HERSHEY_PLAIN, 0.9, cv::Scalar(255, 255, 255), 1);
+        for (int i = 0; i < rows - 1; i++) {
+            cv::putText(frame, describe(i), cv::Point(origin.x, origin.y + 15 * (i + 1)),
+                cv::FONT_HERSHEY_PLAIN, 0.9, cv::Scalar(0, 255, 255), 1);
+        }
+    }
+
+    // Appends one CSV line per stage (unix time, stage, samples, min, mean, p95, p99)
+    bool appendCsv(const std::string& path) const {
+        std::ifstream existing(path);
+        bool writeHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+        existing.close();
+
+        std::ofstream out(path, std::ios::app);
+        if (!out) return false;
+        if (writeHeader) {
+            out << "unix_time,stage,samples,min_ms,mean_ms,p95_ms,p99_ms\n";
+        }
+
+        long long now = (long long)std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        for (int i = 0; i < (int)stageCount(); i++) {
+            LatencySummary s = summary(i);
+            out << now << "," << stageName(i) << "," << s.count << "," << s.minMs << ","
+                << s.meanMs << "," << s.p95Ms << "," << s.p99Ms << "\n";
+        }
+        return (bool)out;
+    }
+
+    // Appends to the CSV file when at least 'interval' has passed since the last dump
+    void dumpIfDue(const std::string& path, std::chrono::seconds interval) {
+        Clock::time_point now = Clock::now();
+        if (now - lastDump < interval) return;
+        lastDump = now;
+        appendCsv(path);
+    }
+
+private:
+    struct Stage {
+        std::string name;
+        std::vector<double> samples; // Ring buffer of the most recent samples
+        size_t next = 0;
+        unsigned long long total = 0;
+    };
+
+    size_t window;
+    mutable std::mutex mutex;
+    std::vector<Stage> stages;
+    Clock::time_point lastDump;
+};
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "grid_fit.hpp"
+
+// Regression cases for fitGrid: lattices it must find and point sets it must refuse.
+// Exits with 1 if any case fails.
+
+using namespace cv;
+using namespace std;
+
+int failures = 0;
+
+void check(bool condition, const string& what) {
+    cout << (condition ? "PASS " : "FAIL ") << what << endl;
+    if (!condition) failures++;
+}
+
+// Centres of a rows x cols board with the given pitch, skipping the (col, row) cells in 'skip'
+vector<Point2f> lattice(int rows, int cols, float pitchX, float pitchY, const vector<Point>& skip = {}) {
+    vector<Point2f> points;
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            bool skipped = false;
+            for (const Point& cell : skip) skipped = skipped || (cell.x == col && cell.y == row);
+            if (!skipped) points.push_back(Point2f(pitchX / 2 + pitchX * col, pitchY / 2 + pitchY * row));
+        }
+    }
+    return points;
+}
+
+int main() {
+    GridFit fit;
+
+    // Full 3x3 board in the rectified view
+    check(fitGrid(lattice(3, 3, 100, 100), 3, 3, fit, Size2d(100, 100)) && fit.outliers == 0 && fit.missing.empty(),
+        "3x3 board fits");
+
+    // One space missed by the detector and one stray detection between rows
+    vector<Point2f> points = lattice(3, 3, 100, 100, { Point(2, 1) });
+    points.push_back(Point2f(150, 195));
+    bool ok = fitGrid(points, 3, 3, fit, Size2d(100, 100));
+    check(ok && fit.outliers == 1 && fit.missingCells.size() == 1 && fit.missingCells[0] == Point(2, 1),
+        "3x3 board with a missing space and an outlier");
+
+    // Taller and wider boards, with two corners missing and no expected pitch
+    ok = fitGrid(lattice(4, 6, 40, 50, { Point(0, 0), Point(5, 3) }), 4, 6, fit);
+    check(ok && fit.missing.size() == 2 && fit.outliers == 0, "4x6 board with two corners missing");
+
+    // A single row of spaces must not be split into three rows a pixel apart
+    vector<Point2f> singleRow = { Point2f(50, 50), Point2f(150, 50.6f), Point2f(250, 49.5f) };
+    check(!fitGrid(singleRow, 3, 3, fit), "single row rejected on a 3x3 board");
+    check(!fitGrid(singleRow, 3, 3, fit, Size2d(100, 100)), "single row rejected with the expected pitch");
+
+    // A lattice far smaller than the board it should fill
+    check(!fitGrid(lattice(3, 3, 20, 20), 3, 3, fit, Size2d(100, 100)), "3x3 lattice at a fifth of the pitch rejected");
+
+    // A one-row board borrows the column pitch for its row
+    check(fitGrid(lattice(1, 4, 75, 300), 1, 4, fit, Size2d(75, 300)) && fit.missing.empty(), "1x4 board fits");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+#include "move_planner.hpp"
+
+// Deterministic checks for the move planners: every plan must be carried out move by move on
+// the board it was made for, and where the planners claim an optimal plan its estimated time
+// must match a brute-force search over the same moves. Exits with 1 if any case fails.
+
+using namespace std;
+
+int failures = 0;
+
+void check(bool condition, const string& what) {
+    cout << (condition ? "PASS " : "FAIL ") << what << endl;
+    if (!condition) failures++;
+}
+
+// Every space of a rows x cols board, in position_id order
+vector<GridCell> boardCells(int rows, int cols) {
+    vector<GridCell> cells;
+    for (int row = 1; row <= rows; row++) {
+        for (int col = 1; col <= cols; col++) {
+            cells.push_back(GridCell{ (row - 1) * cols + col, row, col });
+        }
+    }
+    return cells;
+}
+
+MoveCostModel centredModel(int rows, int cols) {
+    MoveCostModel model;
+    model.homeRow = (rows + 1) / 2.0;
+    model.homeCol = (cols + 1) / 2.0;
+    return model;
+}
+
+// Replays the plan on 'layout'; false if a pick is empty, a place is full, or the estimated
+// times do not add up to the plan total
+bool applyPlan(const vector<GridCell>& cells, BoardLayout& layout, const MovePlan& plan) {
+    double total = 0;
+    for (const PlannedMove& move : plan.moves) {
+        int pick = move.pick.position_id - 1, place = move.place.position_id - 1;
+        if (pick < 0 || place < 0 || pick >= (int)cells.size() || place >= (int)cells.size()) return false;
+        if (layout[pick] == 0 || layout[place] != 0) return false;
+        layout[place] = layout[pick];
+        layout[pick] = 0;
+        total += move.estimatedMs;
+    }
+    return fabs(total - plan.totalMs) < 1e-6;
+}
+
+bool reachesTarget(const BoardLayout& layout, const BoardLayout& target) {
+    for (size_t i = 0; i < layout.size(); i++) {
+        if (target[i] != LAYOUT_ANY && layout[i] != target[i]) return false;
+    }
+    return true;
+}
+
+// Fastest transfer plan by trying every assignment and order
+double bruteForceTransfers(const vector<GridCell>& blocks, const vector<GridCell>& spaces, const MoveCostModel& model,
+    bool separateCommands, vector<bool>& blockUsed, vector<bool>& spaceUsed, size_t movesLeft,
+    double armRow, double armCol, bool first) {
+    if (movesLeft == 0) return 0;
+    double best = numeric_limits<double>::infinity();
+    double settle = (!first && separateCommands) ? model.settleMs : 0;
+    for (size_t b = 0; b < blocks.size(); b++) {
+        if (blockUsed[b]) continue;
+        blockUsed[b] = true;
+        for (size_t s = 0; s < spaces.size(); s++) {
+            if (spaceUsed[s]) continue;
+            spaceUsed[s] = true;
+            double ms = settle + model.moveMs(blocks[b], spaces[s], armRow, armCol);
+            best = min(best, ms + bruteForceTransfers(blocks, spaces, model, separateCommands, blockUsed, spaceUsed,
+                movesLeft - 1, spaces[s].row, spaces[s].col, false));
+            spaceUsed[s] = false;
+        }
+        blockUsed[b] = false;
+    }
+    return best;
+}
+
+// Fastest time to any layout matching 'target' with every pick/place allowed (Dijkstra over
+// layout and arm position); only practical for small boards
+double bruteForceLayout(const vector<GridCell>& cells, const BoardLayout& current, const BoardLayout& target,
+    const MoveCostModel& model, bool separateCommands) {
+    typedef pair<BoardLayout, int> State; // Layout and the cell the arm is over (-1 for home)
+    map<State, double> done;
+    typedef pair<double, State> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> open;
+    open.push(Entry(0, State(current, -1)));
+    while (!open.empty()) {
+        Entry top = open.top();
+        open.pop();
+        if (done.count(top.second)) continue;
+        done[top.second] = top.first;
+        const BoardLayout& layout = top.second.first;
+        int arm = top.second.second;
+        if (reachesTarget(layout, target)) return top.first;
+
+        double armRow = arm < 0 ? model.homeRow : cells[arm].row;
+        double armCol = arm < 0 ? model.homeCol : cells[arm].col;
+        double settle = (arm >= 0 && separateCommands) ? model.settleMs : 0;
+        for (size_t p = 0; p < cells.size(); p++) {
+            if (layout[p] == 0) continue;
+            for (size_t q = 0; q < cells.size(); q++) {
+                if (layout[q] != 0) continue;
+                BoardLayout next = layout;
+                next[q] = layout[p];
+                next[p] = 0;
+                State state(next, (int)q);
+                if (done.count(state)) continue;
+                open.push(Entry(top.first + settle + model.moveMs(cells[p], cells[q], armRow, armCol), state));
+            }
+        }
+    }
+    return numeric_limits<double>::infinity();
+}
+
+// Moves every block of 'fromCol' into the free spaces of 'toCol'
+void transferCase(int rows, int cols, int fromCol, int toCol, bool separateCommands) {
+    vector<GridCell> cells = boardCells(rows, cols), blocks, spaces;
+    for (const GridCell& cell : cells) {
+        if (cell.col == fromCol) blocks.push_back(cell);
+        if (cell.col == toCol) spaces.push_back(cell);
+    }
+    MoveCostModel model = centredModel(rows, cols);
+    MovePlan plan = planTransfers(blocks, spaces, model, separateCommands);
+
+    string name = "transfer " + to_string(rows) + "x" + to_string(cols) + " C" + to_string(fromCol) +
+        " -> C" + to_string(toCol) + (separateCommands ? " separate" : " framed");
+    BoardLayout layout(cells.size(), 0);
+    for (const GridCell& block : blocks) layout[block.position_id - 1] = 1;
+    check(plan.moves.size() == min(blocks.size(), spaces.size()) && applyPlan(cells, layout, plan), name + " is valid");
+
+    if (plan.optimal) {
+        vector<bool> blockUsed(blocks.size(), false), spaceUsed(spaces.size(), false);
+        double best = bruteForceTransfers(blocks, spaces, model, separateCommands, blockUsed, spaceUsed,
+            plan.moves.size(), model.homeRow, model.homeCol, true);
+        check(fabs(plan.totalMs - best) < 1e-6, name + " is optimal");
+    }
+}
+
+void layoutCase(const string& name, int rows, int cols, const BoardLayout& current, const BoardLayout& target,
+    bool legacyMovesOnly, bool compareWithBruteForce) {
+    vector<GridCell> cells = boardCells(rows, cols);
+    MoveCostModel model = centredModel(rows, cols);
+    LayoutPlanner planner;
+    MovePlan plan;
+    string error;
+    bool ok = planner.plan(cells, current, target, model, legacyMovesOnly, legacyMovesOnly, plan, error);
+
+    BoardLayout layout = current;
+    check(ok && applyPlan(cells, layout, plan) && reachesTarget(layout, target), "layout " + name + " is valid");
+    if (ok && compareWithBruteForce) {
+        check(plan.optimal && fabs(plan.totalMs - bruteForceLayout(cells, current, target, model, legacyMovesOnly)) < 1e-6,
+            "layout " + name + " is optimal");
+    }
+}
+
+int main() {
+    transferCase(3, 3, 3, 1, true);
+    transferCase(3, 3, 1, 3, false);
+    transferCase(4, 6, 6, 1, true);
+    transferCase(6, 4, 4, 1, true); // Too many orderings for the exhaustive search
+    transferCase(8, 8, 8, 1, false);
+
+    layoutCase("3x3 column 1 to column 3", 3, 3,
+        { 1, 0, 0, 2, 0, 0, 3, 0, 0 },
+        { 0, 0, 1, 0, 0, 2, 0, 0, 3 }, false, true);
+    layoutCase("3x3 swap in place", 3, 3,
+        { 1, 2, 0, 0, 0, 0, 0, 0, 0 },
+        { 2, 1, LAYOUT_ANY, LAYOUT_ANY, LAYOUT_ANY, LAYOUT_ANY, LAYOUT_ANY, LAYOUT_ANY, LAYOUT_ANY }, false, true);
+    layoutCase("3x3 rotate a row", 3, 3,
+        { 1, 2, 3, 0, 0, 0, 0, 0, 0 },
+        { 3, 1, 2, 0, 0, 0, 0, 0, 0 }, false, true);
+    layoutCase("3x3 legacy moves only", 3, 3,
+        { 1, 0, 0, 2, 0, 0, 3, 0, 0 },
+        { 0, 0, 3, 0, 0, 1, 0, 0, 2 }, true, false);
+
+    BoardLayout current(24, 0), target(24, 0);
+    int colours[4] = { 1, 2, 3, 1 };
+    for (int row = 0; row < 4; row++) {
+        current[row * 6] = colours[row];
+        target[row * 6 + 5] = colours[3 - row];
+    }
+    layoutCase("4x6 column 1 reversed into column 6", 4, 6, current, target, false, false);
+
+    // A refined cost model must not be answered from a plan made with the old estimates
+    vector<GridCell> cells = boardCells(3, 3);
+    MoveCostModel model = centredModel(3, 3);
+    LayoutPlanner planner;
+    MovePlan first, second;
+    string error;
+    BoardLayout from = { 1, 0, 0, 0, 0, 0, 0, 0, 0 }, to = { 0, 0, 1, 0, 0, 0, 0, 0, 0 };
+    planner.plan(cells, from, to, model, false, false, first, error);
+    model.observe(cells[0], cells[2], model.homeRow, model.homeCol, 60000);
+    planner.plan(cells, from, to, model, false, false, second, error);
+    check(planner.cacheHits == 0 && second.totalMs > first.totalMs, "layout cache follows the cost model");
+
+    return failures == 0 ? 0 : 1;
+}